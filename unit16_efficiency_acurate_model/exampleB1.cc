@@ -4,6 +4,11 @@
 
 #include "SYPDetectorConstruction.hh"
 #include "SYPActionInitialization.hh"
+#include "SYPSeeding.hh"
+#include "SYPGeometryChecker.hh"
+#include "SYPCADBenchmark.hh"
+#include "SYPRunComparison.hh"
+#include "SYPTallyCheck.hh"
 
 #ifdef G4MULTITHREADED
 #include "G4MTRunManager.hh"
@@ -12,85 +17,405 @@
 #endif
 
 #include "G4UImanager.hh"
+#include "G4StateManager.hh"
+#include "G4VStateDependent.hh"
 #include "QBBC.hh"
 #include "G4PhysListFactory.hh"
+#include "G4GenericBiasingPhysics.hh"
 
+#ifdef SYP_WITH_UIVIS
 #include "G4VisExecutive.hh"
 #include "G4UIExecutive.hh"
+#endif
+#include "G4Timer.hh"
 
 #include "Randomize.hh"
 #include "time.h"
+#include <unistd.h>
+#include <sstream>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace {
+  void PrintUsage() {
+    G4cerr << " Usage: " << G4endl;
+    G4cerr << " exampleB1 [macro] [options]" << G4endl;
+    G4cerr << "   -s, --seed masterSeed    master seed of the MixMax streams"
+           << G4endl;
+    G4cerr << "   -j, --job jobIndex       job index of the MixMax streams"
+           << G4endl;
+    G4cerr << "   -t, --threads n          number of worker threads"
+           << G4endl;
+    G4cerr << "   -n, --events n           events per run (per sweep point)"
+           << G4endl;
+    G4cerr << "   -e, --energy E           primary energy in MeV" << G4endl;
+    G4cerr << "   -o, --output file        binary results file" << G4endl;
+    G4cerr << "   --tag name               tag stored with the runs"
+           << G4endl;
+    G4cerr << "   --sweep energy=a:b:step  one run per energy from a to b MeV"
+           << G4endl;
+    G4cerr << "   --bias                   force the gamma collisions in"
+           << " the chambers" << G4endl;
+    G4cerr << "   --check-geometry         check the overlaps and exit" << G4endl;
+    G4cerr << "   --resolution n           points per surface (10000)"
+           << G4endl;
+    G4cerr << "   --report file            JSON report (geometryCheck.json)"
+           << G4endl;
+    G4cerr << "   --cad-benchmark file     time the reading of a CAD mesh"
+           << " and exit" << G4endl;
+    G4cerr << "   --compare ref tag        compare the last runs of two tags"
+           << " of the results file and exit" << G4endl;
+    G4cerr << "   --check-tally            check the efficiency error on"
+           << " weighted toy runs and exit" << G4endl;
+    G4cerr << " The macro is executed first, then the runs requested by"
+           << G4endl;
+    G4cerr << " --events/--sweep are done in the same process." << G4endl;
+    G4cerr << " Without macro and runs, an interactive session is started."
+           << G4endl;
+    G4cerr << " With --check-geometry, the macro may only set the geometry;"
+           << G4endl;
+    G4cerr << " the exit status is 2 if a volume overlaps." << G4endl;
+    G4cerr << " With --compare, it is 2 if the efficiencies disagree,"
+           << G4endl;
+    G4cerr << " with --check-tally if the errors disagree with the spread."
+           << G4endl;
+  }
+
+  // Build the geometry alone and check all its placements in parallel
+  G4int CheckGeometry(const G4String& macro, G4int nofThreads,
+                      G4int resolution, const G4String& report) {
+    SYPDetectorConstruction* detector = new SYPDetectorConstruction();
+    if ( ! macro.empty() ) {
+      G4UImanager::GetUIpointer()->ApplyCommand("/control/execute " + macro);
+    }
+    detector->Construct();
+
+    SYPGeometryChecker checker;
+    checker.SetNofThreads(nofThreads);
+    checker.SetResolution(resolution);
+    G4int nofOverlaps = checker.Check();
+    if ( ! checker.WriteReport(report) ) {
+      G4cerr << " Cannot write " << report << G4endl;
+      return 1;
+    }
+    G4cout << " Report written to " << report << G4endl;
+
+    delete detector;
+    return ( nofOverlaps > 0 ) ? 2 : 0;
+  }
+
+  // "energy=0.1:3:0.1" -> the energies 0.1, 0.2, ..., 3 (MeV)
+  G4bool ParseSweep(const G4String& spec, std::vector<G4double>& values) {
+    std::size_t equal = spec.find('=');
+    if ( equal == std::string::npos || spec.substr(0, equal) != "energy" ) {
+      return false;
+    }
+    G4double start, stop, step;
+    char colon1, colon2;
+    std::istringstream range(spec.substr(equal+1));
+    if ( !(range >> start >> colon1 >> stop >> colon2 >> step)
+         || colon1 != ':' || colon2 != ':' || step <= 0. || stop < start ) {
+      return false;
+    }
+    // computed from the index, the points do not drift with the step
+    G4int nofPoints = G4int((stop-start)/step + 1.e-9) + 1;
+    for ( G4int i = 0; i < nofPoints; i++ ) {
+      values.push_back(start + i*step);
+    }
+    return true;
+  }
+
+  // Wall-clock start-up time, printed when the first run with events
+  // starts: it includes the geometry and physics construction done by
+  // /run/initialize and, in sequential mode, the physics tables built
+  // by the first /run/beamOn. Without such a run, Stop() is called at
+  // the end of the batch processing.
+  class StartupTimer : public G4VStateDependent {
+    public:
+      StartupTimer() : fStopped(false) { fTimer.Start(); }
+
+      virtual G4bool Notify(G4ApplicationState requestedState) {
+        G4RunManager* runManager = G4RunManager::GetRunManager();
+        if ( requestedState == G4State_GeomClosed && runManager
+             && runManager->GetNumberOfEventsToBeProcessed() > 0 ) {
+          Stop();
+        }
+        return true;
+      }
+
+      void Stop() {
+        if ( fStopped ) return;
+        fTimer.Stop();
+        fStopped = true;
+        G4cout << " Start-up time: " << fTimer.GetRealElapsed() << " s"
+               << G4endl;
+      }
+
+      // interactive sessions are not timed
+      void Cancel() { fStopped = true; }
+
+    private:
+      G4Timer fTimer;
+      G4bool fStopped;
+  };
+
+  G4String EnergyCommand(G4double energy) {
+    std::ostringstream command;
+    command.precision(10);
+    command << "/gun/energy " << energy << " MeV";
+    return command.str();
+  }
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 int main(int argc,char** argv)
 {
-  // Detect interactive mode (if no arguments) and define UI session
+  // Time the start-up, up to the first run
+  StartupTimer startupTimer;
+
+  // Evaluate arguments
   //
+  G4String macro;
+  G4String output;
+  G4long masterSeed = -1;
+  G4int jobIndex = 0;
+  G4int nofThreads = 0;
+  G4int nofEvents = 0;
+  G4double energy = 0.;
+  std::vector<G4double> sweepEnergies;
+  G4bool forcedCollision = false;
+  G4bool checkGeometry = false;
+  G4bool checkTally = false;
+  G4int resolution = 10000;
+  G4String report = "geometryCheck.json";
+  G4String cadBenchmark;
+  G4String tag;
+  G4String referenceTag;
+  G4String comparedTag;
+  for ( G4int i=1; i<argc; i=i+1 ) {
+    G4String arg = argv[i];
+    G4bool hasValue = i+1 < argc;
+    if ( ( arg == "-s" || arg == "--seed" ) && hasValue ) {
+      masterSeed = atol(argv[++i]);
+    }
+    else if ( ( arg == "-j" || arg == "--job" ) && hasValue ) {
+      jobIndex = atoi(argv[++i]);
+    }
+    else if ( ( arg == "-t" || arg == "--threads" ) && hasValue ) {
+      nofThreads = atoi(argv[++i]);
+    }
+    else if ( ( arg == "-n" || arg == "--events" ) && hasValue ) {
+      nofEvents = atoi(argv[++i]);
+    }
+    else if ( ( arg == "-e" || arg == "--energy" ) && hasValue ) {
+      energy = atof(argv[++i]);
+    }
+    else if ( ( arg == "-o" || arg == "--output" ) && hasValue ) {
+      output = argv[++i];
+    }
+    else if ( arg == "--tag" && hasValue ) {
+      tag = argv[++i];
+    }
+    else if ( arg == "--sweep" && hasValue ) {
+      if ( ! ParseSweep(argv[++i], sweepEnergies) ) {
+        G4cerr << " Invalid sweep: " << argv[i] << G4endl;
+        PrintUsage();
+        return 1;
+      }
+    }
+    else if ( arg == "--bias" ) {
+      forcedCollision = true;
+    }
+    else if ( arg == "--check-geometry" ) {
+      checkGeometry = true;
+    }
+    else if ( arg == "--check-tally" ) {
+      checkTally = true;
+    }
+    else if ( arg == "--resolution" && hasValue ) {
+      resolution = atoi(argv[++i]);
+    }
+    else if ( arg == "--report" && hasValue ) {
+      report = argv[++i];
+    }
+    else if ( arg == "--cad-benchmark" && hasValue ) {
+      cadBenchmark = argv[++i];
+    }
+    else if ( arg == "--compare" && i+2 < argc ) {
+      referenceTag = argv[++i];
+      comparedTag = argv[++i];
+    }
+    else if ( arg[0] != '-' && macro.empty() ) {
+      macro = arg;
+    }
+    else {
+      PrintUsage();
+      return 1;
+    }
+  }
+  if ( ! sweepEnergies.empty() && nofEvents <= 0 ) {
+    G4cerr << " --sweep needs --events" << G4endl;
+    PrintUsage();
+    return 1;
+  }
+
+  // Parsing throughput of the CAD readers, without geometry
+  if ( ! cadBenchmark.empty() ) {
+    SYPCADBenchmark benchmark;
+    return benchmark.Run(cadBenchmark) ? 0 : 1;
+  }
+
+  // Efficiency error against the spread of toy runs
+  if ( checkTally ) {
+    SYPTallyCheck tallyCheck;
+    return tallyCheck.Check() ? 0 : 2;
+  }
+
+  // Agreement and figure of merit of two stored runs
+  if ( ! referenceTag.empty() ) {
+    SYPRunComparison comparison(output.empty() ? "SYPResults.dat" : output);
+    G4int nofOutliers = comparison.Compare(referenceTag, comparedTag);
+    if ( nofOutliers < 0 ) return 1;
+    return ( nofOutliers > 0 ) ? 2 : 0;
+  }
+
+  // Validation pass, without run manager and physics
+  if ( checkGeometry ) {
+    return CheckGeometry(macro, nofThreads, resolution, report);
+  }
+
+  // Detect interactive mode (if no macro and no runs) and define UI session
+  //
+  G4bool interactive = macro.empty() && nofEvents <= 0;
+#ifdef SYP_WITH_UIVIS
   G4UIExecutive* ui = 0;
-  if ( argc == 1 ) {
+  if ( interactive ) {
     ui = new G4UIExecutive(argc, argv);
   }
+#else
+  if ( interactive ) {
+    G4cerr << " Built without UI and vis, a macro or --events is needed"
+           << G4endl;
+    PrintUsage();
+    return 1;
+  }
+#endif
 
-  // Optionally: choose a different Random engine...
-    CLHEP::HepRandom::setTheEngine(new CLHEP::RanecuEngine());
-    G4long seed = time(NULL);
-    CLHEP::HepRandom::setTheSeed(seed);
+  // Seed the MixMax engine from the master seed and job index.
+  // Without -s the seed is taken from the time and process id; it is
+  // printed and stored with the results, so the job can be re-run.
+  if ( masterSeed < 0 ) {
+    masterSeed = (time(NULL) ^ ((G4long)getpid() << 16)) & 0x7fffffffL;
+  }
+  SYPSeeding::Instance()->SetSeeds(masterSeed, jobIndex);
   
   // Construct the default run manager
   //
-//#ifdef G4MULTITHREADED
-  // G4MTRunManager* runManager = new G4MTRunManager;
-//#else
+#ifdef G4MULTITHREADED
+  G4MTRunManager* runManager = new G4MTRunManager;
+  if ( nofThreads > 0 ) {
+    runManager->SetNumberOfThreads(nofThreads);
+  }
+#else
   G4RunManager* runManager = new G4RunManager;
-//#endif
+#endif
 
   // Set mandatory initialization classes
   //
   // Detector construction
-  runManager->SetUserInitialization(new SYPDetectorConstruction());
+  SYPDetectorConstruction* detector = new SYPDetectorConstruction();
+  detector->SetForcedCollision(forcedCollision);
+  runManager->SetUserInitialization(detector);
 
   // Physics list
   G4PhysListFactory factory;
   G4VModularPhysicsList* physicsList = nullptr;
   G4String physName = "QBBC_EMZ";
   physicsList = factory.GetReferencePhysList(physName);
+  if ( forcedCollision ) {
+    // the gammas are forced to interact in the chambers and the
+    // electrons counted with their weights (see SYPRun)
+    G4GenericBiasingPhysics* biasingPhysics = new G4GenericBiasingPhysics();
+    biasingPhysics->Bias("gamma");
+    physicsList->RegisterPhysics(biasingPhysics);
+  }
   runManager->SetUserInitialization(physicsList);
     
   // User action initialization
   runManager->SetUserInitialization(new SYPActionInitialization());
   
-  // Initialize visualization
+  // Initialize visualization, in interactive mode only:
+  // batch jobs do not pay for the registration of the graphics systems
   //
-  G4VisManager* visManager = new G4VisExecutive;
-  // G4VisExecutive can take a verbosity argument - see /vis/verbose guidance.
-  // G4VisManager* visManager = new G4VisExecutive("Quiet");
-  visManager->Initialize();
+#ifdef SYP_WITH_UIVIS
+  G4VisManager* visManager = 0;
+  if ( ui ) {
+    visManager = new G4VisExecutive;
+    // G4VisExecutive can take a verbosity argument - see /vis/verbose guidance.
+    // G4VisManager* visManager = new G4VisExecutive("Quiet");
+    visManager->Initialize();
+  }
+#endif
 
   // Get the pointer to the User Interface manager
   G4UImanager* UImanager = G4UImanager::GetUIpointer();
 
-  // Process macro or start UI session
+  if ( ! output.empty() ) {
+    UImanager->ApplyCommand("/SYP/results/fileName " + output);
+  }
+  if ( ! tag.empty() ) {
+    UImanager->ApplyCommand("/SYP/results/tag " + tag);
+  }
+
+  // Process macro and runs or start UI session
   //
-  if ( ! ui ) { 
+  if ( ! interactive ) { 
     // batch mode
-    G4String command = "/control/execute ";
-    G4String fileName = argv[1];
-    UImanager->ApplyCommand(command+fileName);
+    if ( ! macro.empty() ) {
+      G4String command = "/control/execute ";
+      UImanager->ApplyCommand(command+macro);
+    }
+
+    // the geometry and physics tables are built once for all the runs
+    if ( nofEvents > 0 ) {
+      if ( G4StateManager::GetStateManager()->GetCurrentState()
+           == G4State_PreInit ) {
+        runManager->Initialize();
+      }
+      if ( sweepEnergies.empty() && energy > 0. ) {
+        sweepEnergies.push_back(energy);
+      }
+      if ( sweepEnergies.empty() ) {
+        runManager->BeamOn(nofEvents);
+      }
+      for ( std::size_t i = 0; i < sweepEnergies.size(); i++ ) {
+        UImanager->ApplyCommand(EnergyCommand(sweepEnergies[i]));
+        runManager->BeamOn(nofEvents);
+      }
+    }
+    startupTimer.Stop();
   }
+#ifdef SYP_WITH_UIVIS
   else { 
     // interactive mode
+    startupTimer.Cancel();
     UImanager->ApplyCommand("/control/execute init_vis.mac");
     ui->SessionStart();
     delete ui;
   }
+#endif
 
   // Job termination
   // Free the store: user actions, physics_list and detector_description are
   // owned and deleted by the run manager, so they should not be deleted 
   // in the main() program !
   
+  delete SYPSeeding::Instance();
+#ifdef SYP_WITH_UIVIS
   delete visManager;
+#endif
   delete runManager;
 }
 
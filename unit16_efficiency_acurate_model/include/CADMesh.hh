@@ -93,6 +93,9 @@ Type TypeFromName(G4String name);
 #include "G4ThreeVector.hh"
 #include "G4TriangularFacet.hh"
 
+#include <array>
+#include <cmath>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -100,31 +103,58 @@ namespace CADMesh {
 
 typedef std::vector<G4ThreeVector> Points;
 typedef std::vector<G4TriangularFacet *> Triangles;
+typedef std::vector<std::array<uint32_t, 3>> TriangleIndices;
 
+// The triangles, and the same triangles as indices into the welded points.
+// Without points and indices given, they are built on first use by
+// welding the equal vertices. The triangles of a reader are shared with
+// the meshes copied from it; the scaled, offset or cached triangles are
+// owned by their mesh and deleted with it.
 class Mesh {
 public:
   Mesh(Points points, Triangles triangles, G4String name = "");
+  Mesh(Points points, TriangleIndices indices, Triangles triangles,
+       G4String name = "");
+  ~Mesh();
+
+  Mesh(const Mesh &) = delete;
+  Mesh &operator=(const Mesh &) = delete;
 
   static std::shared_ptr<Mesh> New(Points points, Triangles triangles,
                                    G4String name = "");
 
+  static std::shared_ptr<Mesh> New(Points points, TriangleIndices indices,
+                                   Triangles triangles, G4String name = "");
+
   static std::shared_ptr<Mesh> New(Triangles triangles, G4String name = "");
 
   static std::shared_ptr<Mesh> New(std::shared_ptr<Mesh> mesh,
                                    G4String name = "");
 
 public:
-  G4String GetName();
-  Points GetPoints();
-  Triangles GetTriangles();
+  const G4String &GetName() const;
+  const Points &GetPoints();
+  const Triangles &GetTriangles() const;
+  const TriangleIndices &GetTriangleIndices();
+
+  // Merge the vertices closer than the tolerance into one point, equal
+  // vertices only with a zero tolerance. The triangles are not moved.
+  void Weld(G4double tolerance = 0.);
 
+  // Every edge shared by exactly two triangles.
   G4bool IsValidForNavigation();
 
+  void SetOwnsTriangles(G4bool owns) { owns_triangles_ = owns; }
+
 private:
   G4String name_ = "";
+  G4bool owns_triangles_ = false;
 
   Points points_;
   Triangles triangles_;
+
+  TriangleIndices indices_;
+  G4bool indexed_ = false;
 };
 
 typedef std::vector<std::shared_ptr<Mesh>> Meshes;
@@ -168,6 +198,13 @@ private:
 #include <iostream>
 #include <string>
 
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+
 namespace CADMesh {
 
 namespace File {
@@ -175,8 +212,8 @@ namespace File {
 struct Token {
   std::string name;
 
-  bool operator==(Token other) { return name == other.name; };
-  bool operator!=(Token other) { return name != other.name; };
+  bool operator==(const Token &other) const { return name == other.name; };
+  bool operator!=(const Token &other) const { return name != other.name; };
 };
 
 static Token ErrorToken{"ErrorToken"};
@@ -217,6 +254,7 @@ typedef Items::iterator ItemsIterator;
 class Lexer;
 
 struct State {
+  virtual ~State() {}
   virtual State *operator()(Lexer *) const = 0;
 };
 
@@ -224,9 +262,34 @@ struct __FinalState : public State {
   State *operator()(Lexer *) const { return nullptr; }
 };
 
+// A whole file, memory-mapped where possible, else read into memory.
+class MappedFile {
+public:
+  MappedFile(std::string filepath);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+public:
+  bool IsOpen() { return open_; }
+  std::string_view Data() { return data_; }
+
+private:
+  std::string_view data_;
+  std::string buffer_;
+  void *map_ = nullptr;
+  size_t map_size_ = 0;
+  bool open_ = false;
+};
+
 class Lexer {
 public:
   Lexer(std::string filepath, State *initial_state = nullptr);
+  ~Lexer();
+
+  Lexer(const Lexer &) = delete;
+  Lexer &operator=(const Lexer &) = delete;
 
 public:
   std::string String();
@@ -237,8 +300,8 @@ public:
   void Backup();
   void BackupTo(int position);
 
-  std::string Next();
-  std::string Peek();
+  std::string_view Next();
+  std::string_view Peek();
 
   void Skip();
 
@@ -247,10 +310,10 @@ public:
   Item *EndOfA(Token token, std::string error = "");
   Item *MaybeEndOfA(Token token, std::string error = "");
 
-  bool OneOf(std::string possibles);
-  bool ManyOf(std::string possibles);
-  bool Until(std::string match);
-  bool MatchExactly(std::string match);
+  bool OneOf(std::string_view possibles);
+  bool ManyOf(std::string_view possibles);
+  bool Until(std::string_view match);
+  bool MatchExactly(std::string_view match);
 
   bool OneDigit();
   bool ManyDigits();
@@ -282,12 +345,20 @@ public:
   size_t LineNumber();
 
 private:
-  State *state_;
+  // Advance over the characters for which the predicate holds, no line
+  // break among them.
+  template <typename Predicate> bool ManyWhere(Predicate predicate);
 
+  State *state_ = nullptr;
+
+  Item *root_item_ = nullptr;
   Item *parent_item_ = nullptr;
   Items items_;
 
-  std::string input_;
+  // The lexer only moves positions over the file; a token is copied
+  // once, by ThisIsA.
+  MappedFile file_;
+  std::string_view input_;
 
   size_t position_ = 0;
   size_t start_ = 0;
@@ -301,6 +372,113 @@ private:
 
   std::string last_error_ = "";
 };
+
+// Conversion of the Number tokens, without a locale or a copy.
+inline double ParseDouble(const std::string &value) {
+  const char *first = value.data();
+  const char *last = first + value.size();
+
+  if (first != last && *first == '+')
+    first++;
+
+#if defined(__cpp_lib_to_chars)
+  double number = 0.;
+  std::from_chars(first, last, number);
+  return number;
+#else
+  return std::strtod(first, nullptr);
+#endif
+}
+
+// Conversion of a number in place, e.g. in a mapped file; returns the end
+// of the number, or nullptr if there is none at first.
+inline const char *ParseDouble(const char *first, const char *last,
+                               double &number) {
+  if (first != last && *first == '+')
+    first++;
+
+#if defined(__cpp_lib_to_chars)
+  auto result = std::from_chars(first, last, number);
+  return (result.ec == std::errc()) ? result.ptr : nullptr;
+#else
+  char buffer[64];
+  size_t size = std::min<size_t>(last - first, sizeof(buffer) - 1);
+  std::memcpy(buffer, first, size);
+  buffer[size] = '\0';
+
+  char *end = nullptr;
+  number = std::strtod(buffer, &end);
+  return (end != buffer) ? first + (end - buffer) : nullptr;
+#endif
+}
+
+inline int ParseInt(const std::string &value) {
+  const char *first = value.data();
+  const char *last = first + value.size();
+
+  if (first != last && *first == '+')
+    first++;
+
+  int number = 0;
+  std::from_chars(first, last, number);
+  return number;
+}
+
+// The text after a UTF-8 byte order mark, if any.
+inline std::string_view SkipByteOrderMark(std::string_view data) {
+  if (data.compare(0, 3, "\xEF\xBB\xBF") == 0)
+    data.remove_prefix(3);
+
+  return data;
+}
+
+// Scalars of the binary formats, at any alignment, byte-swapped when the
+// file and host byte orders differ.
+inline bool IsHostBigEndian() {
+  const uint16_t one = 1;
+  unsigned char first_byte;
+  std::memcpy(&first_byte, &one, 1);
+
+  return first_byte == 0;
+}
+
+template <typename T> inline T FromBytes(const char *data, bool swap) {
+  T value;
+
+  if (swap) {
+    char bytes[sizeof(T)];
+    std::reverse_copy(data, data + sizeof(T), bytes);
+    std::memcpy(&value, bytes, sizeof(T));
+  }
+
+  else {
+    std::memcpy(&value, data, sizeof(T));
+  }
+
+  return value;
+}
+
+// On-disk cache of the meshes of a file, scaled and offset, as points and
+// index triangles. A cache file is named after a hash of the file
+// contents, the reader, the scale and the offset, so any change misses
+// the cache and reads the file again. The files are in the host byte
+// order, with the key in their header.
+class MeshCache {
+public:
+  MeshCache(G4String directory);
+
+public:
+  static uint64_t Key(std::string_view contents, G4String reader_name,
+                      G4double scale, G4ThreeVector offset);
+
+  G4String FilePath(uint64_t key);
+
+  G4bool Load(uint64_t key, Meshes &meshes);
+  G4bool Save(uint64_t key, const Meshes &meshes);
+
+private:
+  G4String directory_;
+};
 }
 }
 
@@ -424,6 +602,20 @@ public:
   void SetOffset(G4ThreeVector offset);
   G4ThreeVector GetOffset();
 
+  // Defaults to the CADMESH_CACHE_DIR environment variable. An empty
+  // directory disables the cache.
+  void SetCacheDirectory(G4String directory);
+  G4String GetCacheDirectory();
+
+  // The meshes of the file, scaled and offset.
+  Meshes GetMeshes();
+  std::shared_ptr<Mesh> GetMesh(size_t index);
+  std::shared_ptr<Mesh> GetMesh(G4String name, G4bool exact = true);
+
+protected:
+  void Read();
+  std::shared_ptr<Mesh> Transform(std::shared_ptr<Mesh> mesh);
+
 protected:
   G4String file_name_;
   File::Type file_type_;
@@ -434,6 +626,14 @@ protected:
   G4AssemblyVolume *assembly_ = nullptr;
 
   std::shared_ptr<File::Reader> reader_ = nullptr;
+
+private:
+  G4bool read_ = false;
+  G4String cache_directory_;
+
+  Meshes meshes_;
+  G4double meshes_scale_ = 1.0;
+  G4ThreeVector meshes_offset_;
 };
 }
 
@@ -472,6 +672,7 @@ public:
   G4TessellatedSolid *GetTessellatedSolid();
   G4TessellatedSolid *GetTessellatedSolid(G4int index);
   G4TessellatedSolid *GetTessellatedSolid(G4String name, G4bool exact = true);
+  // The mesh is one of GetMeshes(), already scaled and offset.
   G4TessellatedSolid *GetTessellatedSolid(std::shared_ptr<Mesh> mesh);
 
   G4AssemblyVolume *GetAssembly();
@@ -482,7 +683,10 @@ public:
   G4bool GetReverse() { return this->reverse_; };
 
 private:
-  G4bool reverse_;
+  G4TessellatedSolid *BuildSolid(std::shared_ptr<Mesh> mesh);
+
+private:
+  G4bool reverse_ = false;
 };
 }
 
@@ -490,8 +694,52 @@ private:
 
 #include "tetgen.h"
 
+#include "G4PVParameterised.hh"
+#include "G4VPVParameterisation.hh"
+
 namespace CADMesh {
 
+// The tetrahedra of a mesh as one array a point coordinate and one of four
+// point indices a tetrahedron, for a single parameterised volume: some
+// tens of bytes a tetrahedron, instead of a solid, a logical and a
+// physical volume each.
+class TetrahedralParameterisation : public G4VPVParameterisation {
+public:
+  TetrahedralParameterisation(std::vector<G4double> x, std::vector<G4double> y,
+                              std::vector<G4double> z,
+                              std::vector<uint32_t> indices);
+
+public:
+  // The points are in the frame of the mother volume.
+  void ComputeTransformation(const G4int copy_number,
+                             G4VPhysicalVolume *physical) const;
+
+  void ComputeTet(G4Tet &tet, const G4int copy_number) const;
+
+  size_t GetNumberOfTetrahedra() const { return indices_.size() / 4; }
+  G4ThreeVector GetPoint(size_t tetrahedron, size_t corner) const;
+
+private:
+  std::vector<G4double> x_;
+  std::vector<G4double> y_;
+  std::vector<G4double> z_;
+
+  std::vector<uint32_t> indices_;
+};
+
+// The solid of the parameterised volume, given the vertices of each
+// tetrahedron in turn; cloned for each worker thread.
+class ParameterisedTet : public G4Tet {
+public:
+  using G4Tet::G4Tet;
+
+  void ComputeDimensions(G4VPVParameterisation *parameterisation,
+                         const G4int copy_number,
+                         const G4VPhysicalVolume *physical);
+
+  G4VSolid *Clone() const;
+};
+
 class TetrahedralMesh : public CADMeshTemplate<TetrahedralMesh> {
 public:
   using CADMeshTemplate::CADMeshTemplate;
@@ -508,6 +756,14 @@ public:
 
   G4AssemblyVolume *GetAssembly();
 
+  // All the tetrahedra as one volume placed in the mother, instead of
+  // a volume each in an assembly.
+  G4PVParameterised *GetParameterisedVolume(G4LogicalVolume *mother,
+                                            G4String name = "");
+
+  // Runs tetgen, or loads the tetrahedra, once.
+  void Tetrahedralize();
+
 public:
   void SetMaterial(G4Material *material) { this->material_ = material; };
 
@@ -565,11 +821,28 @@ namespace CADMesh {
 Mesh::Mesh(Points points, Triangles triangles, G4String name)
     : name_(name), points_(points), triangles_(triangles) {}
 
+Mesh::Mesh(Points points, TriangleIndices indices, Triangles triangles,
+           G4String name)
+    : name_(name), points_(points), triangles_(triangles), indices_(indices),
+      indexed_(true) {}
+
+Mesh::~Mesh() {
+  if (owns_triangles_) {
+    for (auto triangle : triangles_)
+      delete triangle;
+  }
+}
+
 std::shared_ptr<Mesh> Mesh::New(Points points, Triangles triangles,
                                 G4String name) {
   return std::make_shared<Mesh>(points, triangles, name);
 }
 
+std::shared_ptr<Mesh> Mesh::New(Points points, TriangleIndices indices,
+                                Triangles triangles, G4String name) {
+  return std::make_shared<Mesh>(points, indices, triangles, name);
+}
+
 std::shared_ptr<Mesh> Mesh::New(Triangles triangles, G4String name) {
   Points points;
 
@@ -577,66 +850,252 @@ std::shared_ptr<Mesh> Mesh::New(Triangles triangles, G4String name) {
 }
 
 std::shared_ptr<Mesh> Mesh::New(std::shared_ptr<Mesh> mesh, G4String name) {
-  return New(mesh->GetPoints(), mesh->GetTriangles(), name);
+  if (mesh->indexed_) {
+    return New(mesh->points_, mesh->indices_, mesh->triangles_, name);
+  }
+
+  return New(mesh->points_, mesh->triangles_, name);
 }
 
-G4String Mesh::GetName() { return name_; }
+const G4String &Mesh::GetName() const { return name_; }
 
-Points Mesh::GetPoints() { return points_; }
+const Points &Mesh::GetPoints() {
+  if (!indexed_)
+    Weld();
 
-Triangles Mesh::GetTriangles() { return triangles_; }
+  return points_;
+}
 
-G4bool Mesh::IsValidForNavigation() {
-  std::map<G4ThreeVector, size_t> point_index;
+const Triangles &Mesh::GetTriangles() const { return triangles_; }
 
-  size_t index = 0;
-  for (auto point : points_) {
-    point_index[point] = index;
-    index++;
-  }
+const TriangleIndices &Mesh::GetTriangleIndices() {
+  if (!indexed_)
+    Weld();
+
+  return indices_;
+}
+
+namespace {
+// Open addressing table with linear probing, kept at most half full: flat
+// arrays and no node allocation.
+template <typename Key, typename Value, typename Hash> class FlatTable {
+public:
+  FlatTable(size_t nof_keys) {
+    size_t size = 16;
+
+    while (size < 2 * nof_keys) {
+      size *= 2;
+    }
 
-  typedef std::pair<size_t, size_t> Edge;
-  std::map<Edge, G4int> edge_use_count;
+    keys_.resize(size);
+    values_.resize(size);
+    used_.resize(size, 0);
+  }
 
-  for (size_t i = 0; i < triangles_.size(); i++) {
-    auto triangle = triangles_[i];
+  Value &operator[](const Key &key) {
+    if (2 * (size_ + 1) > keys_.size()) {
+      Grow();
+    }
 
-    size_t a = point_index[triangle->GetVertex(0)];
-    size_t b = point_index[triangle->GetVertex(1)];
-    size_t c = point_index[triangle->GetVertex(2)];
+    size_t slot = Slot(key);
 
-    if (a < b) {
-      edge_use_count[Edge(a, b)] += 1;
+    if (!used_[slot]) {
+      used_[slot] = 1;
+      keys_[slot] = key;
+      values_[slot] = Value();
+      size_++;
     }
 
-    else if (a > b) {
-      edge_use_count[Edge(b, a)] += 1;
+    return values_[slot];
+  }
+
+  const Value *Find(const Key &key) const {
+    size_t slot = Slot(key);
+
+    return used_[slot] ? &values_[slot] : nullptr;
+  }
+
+  template <typename Function> bool AllOf(Function function) const {
+    for (size_t slot = 0; slot < keys_.size(); slot++) {
+      if (used_[slot] && !function(values_[slot]))
+        return false;
     }
 
-    if (b < c) {
-      edge_use_count[Edge(b, c)] += 1;
+    return true;
+  }
+
+private:
+  size_t Slot(const Key &key) const {
+    size_t mask = keys_.size() - 1;
+    size_t slot = Hash()(key) & mask;
+
+    while (used_[slot] && !(keys_[slot] == key)) {
+      slot = (slot + 1) & mask;
     }
 
-    else if (b > c) {
-      edge_use_count[Edge(c, b)] += 1;
+    return slot;
+  }
+
+  void Grow() {
+    std::vector<Key> keys(2 * keys_.size());
+    std::vector<Value> values(keys.size());
+    std::vector<uint8_t> used(keys.size(), 0);
+
+    keys.swap(keys_);
+    values.swap(values_);
+    used.swap(used_);
+
+    for (size_t slot = 0; slot < keys.size(); slot++) {
+      if (used[slot]) {
+        size_t new_slot = Slot(keys[slot]);
+
+        used_[new_slot] = 1;
+        keys_[new_slot] = keys[slot];
+        values_[new_slot] = values[slot];
+      }
     }
+  }
+
+  std::vector<Key> keys_;
+  std::vector<Value> values_;
+  std::vector<uint8_t> used_;
+  size_t size_ = 0;
+};
+
+uint64_t MixBits(uint64_t key) {
+  key ^= key >> 33;
+  key *= 0xFF51AFD7ED558CCDULL;
+  key ^= key >> 33;
+
+  return key;
+}
+
+struct CellHash {
+  size_t operator()(const std::array<int64_t, 3> &cell) const {
+    return MixBits(cell[0] * 0x9E3779B97F4A7C15ULL ^
+                   cell[1] * 0xC2B2AE3D27D4EB4FULL ^
+                   cell[2] * 0x165667B19E3779F9ULL);
+  }
+};
+
+struct EdgeHash {
+  size_t operator()(uint64_t edge) const { return MixBits(edge); }
+};
+
+const uint32_t NoPoint = UINT32_MAX;
+
+// The first point of a cell, the others chained through next.
+struct CellHead {
+  uint32_t point = NoPoint;
+};
+}
+
+// Spatial hash: with a tolerance, the cells are cubes of that size and a
+// vertex is compared with the points of its cell and of the neighbouring
+// cells; without, a cell is one exact position.
+void Mesh::Weld(G4double tolerance) {
+  points_.clear();
+  indices_.clear();
+  indices_.reserve(triangles_.size());
 
-    if (c < a) {
-      edge_use_count[Edge(c, a)] += 1;
+  // about half as many points as triangles in a closed mesh
+  FlatTable<std::array<int64_t, 3>, CellHead, CellHash> cells(
+      triangles_.size() / 2);
+  std::vector<uint32_t> next;
+
+  auto cell_of = [tolerance](const G4ThreeVector &vertex) {
+    std::array<int64_t, 3> cell;
+
+    for (size_t i = 0; i < 3; i++) {
+      if (tolerance > 0.) {
+        cell[i] = static_cast<int64_t>(std::floor(vertex[i] / tolerance));
+      }
+
+      else {
+        double coordinate = vertex[i] + 0.; // -0 as +0.
+        std::memcpy(&cell[i], &coordinate, sizeof(coordinate));
+      }
     }
 
-    else if (c > a) {
-      edge_use_count[Edge(a, c)] += 1;
+    return cell;
+  };
+
+  int64_t reach = (tolerance > 0.) ? 1 : 0;
+  G4double tolerance2 = tolerance * tolerance;
+
+  for (auto triangle : triangles_) {
+    std::array<uint32_t, 3> indices;
+
+    for (size_t i = 0; i < 3; i++) {
+      auto vertex = triangle->GetVertex(i);
+      auto cell = cell_of(vertex);
+
+      uint32_t index = NoPoint;
+
+      for (int64_t dx = -reach; dx <= reach && index == NoPoint; dx++) {
+        for (int64_t dy = -reach; dy <= reach && index == NoPoint; dy++) {
+          for (int64_t dz = -reach; dz <= reach && index == NoPoint; dz++) {
+            std::array<int64_t, 3> neighbour = {cell[0] + dx, cell[1] + dy,
+                                                cell[2] + dz};
+
+            auto head = cells.Find(neighbour);
+
+            if (!head)
+              continue;
+
+            for (auto point = head->point; point != NoPoint;
+                 point = next[point]) {
+              if ((points_[point] - vertex).mag2() <= tolerance2) {
+                index = point;
+                break;
+              }
+            }
+          }
+        }
+      }
+
+      if (index == NoPoint) {
+        index = points_.size();
+
+        auto &head = cells[cell];
+        next.push_back(head.point);
+        head.point = index;
+
+        points_.push_back(vertex);
+      }
+
+      indices[i] = index;
     }
+
+    indices_.push_back(indices);
   }
 
-  for (auto count : edge_use_count) {
-    if (count.second != 2) {
-      return false;
+  indexed_ = true;
+}
+
+// The edges, keyed by their two point indices, are counted in a flat
+// table: linear in the number of triangles.
+G4bool Mesh::IsValidForNavigation() {
+  const auto &indices = GetTriangleIndices();
+
+  // three halves as many edges as triangles in a closed mesh
+  FlatTable<uint64_t, G4int, EdgeHash> edges(3 * indices.size() / 2);
+
+  for (const auto &triangle : indices) {
+    for (size_t i = 0; i < 3; i++) {
+      uint64_t a = triangle[i];
+      uint64_t b = triangle[(i + 1) % 3];
+
+      if (a == b)
+        continue;
+
+      if (++edges[(a < b) ? (a << 32 | b) : (b << 32 | a)] > 2) {
+        return false;
+      }
     }
   }
 
-  return true;
+  return edges.AllOf([](G4int count) { return count == 2; });
 }
 }
 
@@ -704,27 +1163,84 @@ void Reader::SetMeshes(Meshes meshes) { meshes_ = meshes; }
 #include <sstream>
 #include <streambuf>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace CADMesh {
 
 namespace File {
 
-Lexer::Lexer(std::string filepath, State *initial_state) {
-  std::ifstream file(filepath);
-  input_ = std::string((std::istreambuf_iterator<char>(file)),
-                       std::istreambuf_iterator<char>());
+MappedFile::MappedFile(std::string filepath) {
+#ifndef _WIN32
+  int descriptor = open(filepath.c_str(), O_RDONLY);
+  struct stat status;
+
+  if (descriptor >= 0 && fstat(descriptor, &status) == 0 &&
+      status.st_size > 0) {
+    void *map =
+        mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+    if (map != MAP_FAILED) {
+      map_ = map;
+      map_size_ = status.st_size;
+      madvise(map_, map_size_, MADV_SEQUENTIAL);
+      data_ = std::string_view(static_cast<const char *>(map_), map_size_);
+      open_ = true;
+    }
+  }
+
+  if (descriptor >= 0)
+    close(descriptor);
+#endif
+
+  if (!map_) {
+    std::ifstream file(filepath, std::ios::binary);
+
+    if (!file) {
+      return;
+    }
+
+    buffer_ = std::string((std::istreambuf_iterator<char>(file)),
+                          std::istreambuf_iterator<char>());
+    data_ = buffer_;
+    open_ = true;
+  }
+}
+
+MappedFile::~MappedFile() {
+#ifndef _WIN32
+  if (map_)
+    munmap(map_, map_size_);
+#endif
+}
+
+Lexer::Lexer(std::string filepath, State *initial_state) : file_(filepath) {
+  if (!file_.IsOpen()) {
+    Exceptions::FileNotFound("Lexer::Lexer", filepath);
+  }
+
+  input_ = file_.Data();
 
   if (initial_state) {
     Run(initial_state);
   }
 }
 
+Lexer::~Lexer() { delete root_item_; }
+
 std::string Lexer::String() {
-  return input_.substr(start_, position_ - start_);
+  return std::string(input_.substr(start_, position_ - start_));
 }
 
 void Lexer::Run(State *initial_state, size_t lines) {
-  parent_item_ = new Item{ParentToken, position_,          line_, "", "",
-                          nullptr,     std::vector<Item>()};
+  delete root_item_;
+  root_item_ = new Item{ParentToken, position_,          line_, "", "",
+                        nullptr,     std::vector<Item>()};
+  parent_item_ = root_item_;
 
   state_ = initial_state;
 
@@ -733,33 +1249,35 @@ void Lexer::Run(State *initial_state, size_t lines) {
   if (lines > 0)
     end_line_ = line_ + lines;
 
+  // Each state is allocated by the previous one.
   while (state_) {
-    state_ = (*state_)(this);
+    State *next = (*state_)(this);
+    delete state_;
+    state_ = next;
   }
 }
 
-Items Lexer::GetItems() { return parent_item_->children; }
+// The items are moved out: called once, when the lexer is done.
+Items Lexer::GetItems() { return std::move(root_item_->children); }
 
 void Lexer::Backup() {
   position_ -= width_;
 
-  auto next = input_.substr(position_, 1);
-
-  if (next == "\n") {
+  if (input_[position_] == '\n') {
     line_--;
   }
 }
 
 void Lexer::BackupTo(int position) {
-  auto s = input_.substr(position, position_ - position);
-  line_ -= std::count(s.begin(), s.end(), '\n');
+  line_ -= std::count(input_.begin() + position, input_.begin() + position_,
+                      '\n');
 
   position_ = position;
 }
 
-std::string Lexer::Next() {
-  if (position_ >= input_.length()) {
-    return "";
+std::string_view Lexer::Next() {
+  if (position_ >= input_.size()) {
+    return std::string_view();
   }
 
   auto next = input_.substr(position_, 1);
@@ -767,19 +1285,19 @@ std::string Lexer::Next() {
   width_ = 1;
   position_ += width_;
 
-  if (next == "\n")
+  if (next[0] == '\n')
     line_++;
 
   return next;
 }
 
-std::string Lexer::Peek() {
-  auto next = Next();
-
-  if (next != "")
-    Backup();
+std::string_view Lexer::Peek() {
+  if (position_ >= input_.size()) {
+    return std::string_view();
+  }
 
-  return next;
+  width_ = 1;
+  return input_.substr(position_, 1);
 }
 
 void Lexer::Skip() { start_ = position_; }
@@ -850,20 +1368,17 @@ Item *Lexer::MaybeEndOfA(Token token, std::string error) {
   }
 }
 
-bool Lexer::OneOf(std::string possibles) {
-  auto peek = Peek();
-
-  size_t position = possibles.find(Peek());
-
-  if (position != std::string::npos) {
-    auto next = Next();
-    return next != "";
+bool Lexer::OneOf(std::string_view possibles) {
+  if (position_ >= input_.size() ||
+      possibles.find(input_[position_]) == std::string_view::npos) {
+    return false;
   }
 
-  return false;
+  Next();
+  return true;
 }
 
-bool Lexer::ManyOf(std::string possibles) {
+bool Lexer::ManyOf(std::string_view possibles) {
   bool has = false;
 
   while (OneOf(possibles)) {
@@ -873,53 +1388,79 @@ bool Lexer::ManyOf(std::string possibles) {
   return has;
 }
 
-bool Lexer::Until(std::string match) {
+bool Lexer::Until(std::string_view match) {
   while (!OneOf(match)) {
-    if (Next() == "")
+    if (Next().empty())
       return false;
   }
 
   return true;
 }
 
-bool Lexer::MatchExactly(std::string match) {
+bool Lexer::MatchExactly(std::string_view match) {
+  if (input_.compare(position_, match.size(), match) != 0) {
+    return false;
+  }
+
+  line_ += std::count(match.begin(), match.end(), '\n');
+  position_ += match.size();
+
+  return true;
+}
+
+template <typename Predicate> bool Lexer::ManyWhere(Predicate predicate) {
   auto start_position = position_;
 
-  for (auto m : match) {
-    if (!OneOf(std::string(1, m))) {
-      BackupTo(start_position);
-      return false;
-    }
+  while (position_ < input_.size() && predicate(input_[position_])) {
+    position_++;
   }
 
-  return true;
+  width_ = 1;
+  return position_ > start_position;
 }
 
-bool Lexer::OneDigit() { return OneOf("0123456789"); }
+namespace {
+inline bool IsDigit(char c) { return c >= '0' && c <= '9'; }
 
-bool Lexer::ManyDigits() { return ManyOf("0123456789"); }
+inline bool IsLetter(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
 
-bool Lexer::OneLetter() {
-  return OneOf("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ");
+inline bool IsCharacter(char c) { return c > ' ' && c <= '~'; }
 }
 
-bool Lexer::ManyLetters() {
-  return ManyOf("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ");
+bool Lexer::OneDigit() {
+  if (position_ >= input_.size() || !IsDigit(input_[position_]))
+    return false;
+
+  Next();
+  return true;
 }
 
-bool Lexer::ManyCharacters() {
-  return ManyOf("!\"#$%&\\\'()*+,-./"
-                "0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[|]^_`"
-                "abcdefghijklmnopqrstuvwxyz{}~");
+bool Lexer::ManyDigits() { return ManyWhere(IsDigit); }
+
+bool Lexer::OneLetter() {
+  if (position_ >= input_.size() || !IsLetter(input_[position_]))
+    return false;
+
+  Next();
+  return true;
 }
 
+bool Lexer::ManyLetters() { return ManyWhere(IsLetter); }
+
+bool Lexer::ManyCharacters() { return ManyWhere(IsCharacter); }
+
+// Numbers never span a line break: a failed match only resets the
+// position.
+
 bool Lexer::Integer() {
   auto start_position = position_;
 
   OneOf("+-");
 
   if (!ManyDigits()) {
-    BackupTo(start_position);
+    position_ = start_position;
     return false;
   }
 
@@ -934,14 +1475,14 @@ bool Lexer::Float() {
   bool has_integer = Integer();
 
   if (!OneOf(".")) {
-    BackupTo(start_position);
+    position_ = start_position;
     return false;
   }
 
   bool has_decimal = ManyDigits();
 
   if (!has_integer || !has_decimal) {
-    BackupTo(start_position);
+    position_ = start_position;
     return false;
   }
 
@@ -960,7 +1501,7 @@ bool Lexer::Number() {
   if (OneOf("eE")) {
     if (!Float()) {
       if (!Integer()) {
-        BackupTo(start_position);
+        position_ = start_position;
       }
     }
   }
@@ -1044,14 +1585,22 @@ bool Lexer::TestState(State *state) {
     return false;
 
   auto start_position = position_;
+  auto start_line = line_;
+  auto start = start_;
 
   dry_run_ = true;
 
-  bool state_transition = ((*state)(this) != nullptr);
+  State *next = (*state)(this);
+  bool state_transition = (next != nullptr);
+
+  delete next;
+  delete state;
 
   dry_run_ = false;
 
-  BackupTo(start_position);
+  position_ = start_position;
+  line_ = start_line;
+  start_ = start;
 
   return state_transition;
 }
@@ -1080,48 +1629,272 @@ void Lexer::PrintItem(Item) {}
 }
 }
 
+#include <iomanip>
+
 namespace CADMesh {
 
-template <typename T>
-CADMeshTemplate<T>::CADMeshTemplate() : CADMeshTemplate<T>("") {}
+namespace File {
 
-template <typename T>
-CADMeshTemplate<T>::CADMeshTemplate(G4String file_name)
-    : CADMeshTemplate<T>(file_name, File::Unknown) {}
+namespace {
+const char MeshCacheMagic[8] = {'C', 'A', 'D', 'M', 'E', 'S', 'H', 'C'};
+const uint32_t MeshCacheVersion = 1;
 
-template <typename T>
-CADMeshTemplate<T>::CADMeshTemplate(G4String file_name, File::Type file_type)
-    : CADMeshTemplate<T>(file_name, file_type, File::CADMESH_DEFAULT_READER()) {
-}
+// 64 bit words mixed in turn; enough to tell files apart, not a
+// cryptographic hash.
+uint64_t Hash(const char *data, size_t size, uint64_t hash) {
+  const uint64_t multiplier = 0x9E3779B97F4A7C15ULL;
 
-template <typename T>
-CADMeshTemplate<T>::CADMeshTemplate(std::shared_ptr<File::Reader> reader)
-    : CADMeshTemplate<T>("", reader) {}
+  hash ^= size * multiplier;
 
-template <typename T>
-CADMeshTemplate<T>::CADMeshTemplate(G4String file_name,
-                                    std::shared_ptr<File::Reader> reader)
-    : CADMeshTemplate<T>(file_name, File::Unknown, reader) {}
+  size_t i = 0;
 
-template <typename T>
-CADMeshTemplate<T>::CADMeshTemplate(G4String file_name, File::Type file_type,
-                                    std::shared_ptr<File::Reader> reader) {
-  if (!reader->CanRead(file_type)) {
-    Exceptions::ReaderCantReadError(reader->GetName(), file_type, file_name);
+  for (; i + 8 <= size; i += 8) {
+    uint64_t word;
+    std::memcpy(&word, data + i, 8);
+
+    hash = (hash ^ word) * multiplier;
+    hash ^= hash >> 32;
   }
 
-  file_name_ = file_name;
-  file_type_ = file_type;
+  if (i < size) {
+    uint64_t word = 0;
+    std::memcpy(&word, data + i, size - i);
 
-  scale_ = 1.0;
+    hash = (hash ^ word) * multiplier;
+    hash ^= hash >> 32;
+  }
 
-  offset_ = G4ThreeVector();
+  hash ^= hash >> 33;
+  hash *= 0xFF51AFD7ED558CCDULL;
+  hash ^= hash >> 33;
 
-  verbose_ = 0;
+  return hash;
+}
+
+template <typename T> void Write(std::ofstream &file, T value) {
+  file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+size_t Padding(size_t size) { return (8 - size % 8) % 8; }
+}
+
+MeshCache::MeshCache(G4String directory) : directory_(directory) {}
+
+uint64_t MeshCache::Key(std::string_view contents, G4String reader_name,
+                        G4double scale, G4ThreeVector offset) {
+  double transform[4] = {scale, offset.x(), offset.y(), offset.z()};
+
+  uint64_t key = Hash(contents.data(), contents.size(), MeshCacheVersion);
+  key = Hash(reader_name.data(), reader_name.size(), key);
+  key = Hash(reinterpret_cast<const char *>(transform), sizeof(transform),
+             key);
+
+  return key;
+}
+
+G4String MeshCache::FilePath(uint64_t key) {
+  std::stringstream path;
+  path << directory_ << "/" << std::hex << std::setfill('0') << std::setw(16)
+       << key << ".cadmesh";
+
+  return path.str();
+}
+
+// Header: magic, version, number of meshes, key. Each mesh: numbers of
+// points and triangles, name size and name, the points as doubles, the
+// triangles as three uint32 indices; each block padded to 8 bytes.
+G4bool MeshCache::Load(uint64_t key, Meshes &meshes) {
+  MappedFile file(FilePath(key));
+
+  if (!file.IsOpen()) {
+    return false;
+  }
+
+  auto data = file.Data();
+  size_t position = 24;
+
+  if (data.size() < position ||
+      data.compare(0, 8, std::string_view(MeshCacheMagic, 8)) != 0 ||
+      FromBytes<uint32_t>(data.data() + 8, false) != MeshCacheVersion ||
+      FromBytes<uint64_t>(data.data() + 16, false) != key) {
+    return false;
+  }
+
+  uint32_t nof_meshes = FromBytes<uint32_t>(data.data() + 12, false);
+
+  Meshes loaded;
+
+  for (uint32_t m = 0; m < nof_meshes; m++) {
+    if (data.size() < position + 24) {
+      return false;
+    }
+
+    uint64_t nof_points = FromBytes<uint64_t>(data.data() + position, false);
+    uint64_t nof_triangles =
+        FromBytes<uint64_t>(data.data() + position + 8, false);
+    uint64_t name_size =
+        FromBytes<uint64_t>(data.data() + position + 16, false);
+    position += 24;
+
+    size_t points_size = 24 * nof_points;
+    size_t triangles_size = 12 * nof_triangles;
+
+    if (data.size() - position < name_size + Padding(name_size) +
+                                     points_size + triangles_size +
+                                     Padding(triangles_size)) {
+      return false;
+    }
+
+    G4String name(std::string(data.substr(position, name_size)));
+    position += name_size + Padding(name_size);
+
+    std::vector<double> coordinates(3 * nof_points);
+    std::memcpy(coordinates.data(), data.data() + position, points_size);
+    position += points_size;
+
+    Points points;
+    points.reserve(nof_points);
+
+    for (size_t i = 0; i < coordinates.size(); i += 3) {
+      points.push_back(G4ThreeVector(coordinates[i], coordinates[i + 1],
+                                     coordinates[i + 2]));
+    }
+
+    TriangleIndices indices(nof_triangles);
+    std::memcpy(indices.data(), data.data() + position, triangles_size);
+    position += triangles_size + Padding(triangles_size);
+
+    Triangles triangles;
+    triangles.reserve(nof_triangles);
+
+    for (const auto &triangle : indices) {
+      if (triangle[0] >= nof_points || triangle[1] >= nof_points ||
+          triangle[2] >= nof_points) {
+        for (auto t : triangles)
+          delete t;
+
+        return false;
+      }
+
+      triangles.push_back(new G4TriangularFacet(points[triangle[0]],
+                                                points[triangle[1]],
+                                                points[triangle[2]], ABSOLUTE));
+    }
+
+    loaded.push_back(Mesh::New(points, indices, triangles, name));
+    loaded.back()->SetOwnsTriangles(true);
+  }
+
+  meshes = loaded;
+
+  return true;
+}
+
+// Written to a temporary file then renamed, so that jobs sharing the
+// directory never read a partial file.
+G4bool MeshCache::Save(uint64_t key, const Meshes &meshes) {
+  auto path = FilePath(key);
+
+  std::stringstream temporary_path;
+  temporary_path << path << ".tmp";
+#ifndef _WIN32
+  temporary_path << "." << getpid();
+#endif
+
+  std::ofstream file(temporary_path.str(), std::ios::binary);
+
+  if (!file) {
+    G4Exception("CADMesh in MeshCache::Save", "CacheNotWritten", JustWarning,
+                ("\nThe cache file: \n\t" + path + "\ncould not be written.")
+                    .c_str());
+    return false;
+  }
+
+  file.write(MeshCacheMagic, 8);
+  Write<uint32_t>(file, MeshCacheVersion);
+  Write<uint32_t>(file, meshes.size());
+  Write<uint64_t>(file, key);
+
+  const char zeros[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+
+  for (const auto &mesh : meshes) {
+    const auto &points = mesh->GetPoints();
+    const auto &indices = mesh->GetTriangleIndices();
+    const auto &name = mesh->GetName();
+
+    Write<uint64_t>(file, points.size());
+    Write<uint64_t>(file, indices.size());
+    Write<uint64_t>(file, name.size());
+    file.write(name.data(), name.size());
+    file.write(zeros, Padding(name.size()));
+
+    for (const auto &point : points) {
+      Write<double>(file, point.x());
+      Write<double>(file, point.y());
+      Write<double>(file, point.z());
+    }
+
+    file.write(reinterpret_cast<const char *>(indices.data()),
+               indices.size() * sizeof(indices[0]));
+    file.write(zeros, Padding(indices.size() * sizeof(indices[0])));
+  }
+
+  file.close();
+
+  if (!file || std::rename(temporary_path.str().c_str(), path.c_str()) != 0) {
+    std::remove(temporary_path.str().c_str());
+    return false;
+  }
+
+  return true;
+}
+}
+}
+
+namespace CADMesh {
+
+template <typename T>
+CADMeshTemplate<T>::CADMeshTemplate() : CADMeshTemplate<T>("") {}
+
+template <typename T>
+CADMeshTemplate<T>::CADMeshTemplate(G4String file_name)
+    : CADMeshTemplate<T>(file_name, File::Unknown) {}
+
+template <typename T>
+CADMeshTemplate<T>::CADMeshTemplate(G4String file_name, File::Type file_type)
+    : CADMeshTemplate<T>(file_name, file_type, File::CADMESH_DEFAULT_READER()) {
+}
+
+template <typename T>
+CADMeshTemplate<T>::CADMeshTemplate(std::shared_ptr<File::Reader> reader)
+    : CADMeshTemplate<T>("", reader) {}
+
+template <typename T>
+CADMeshTemplate<T>::CADMeshTemplate(G4String file_name,
+                                    std::shared_ptr<File::Reader> reader)
+    : CADMeshTemplate<T>(file_name, File::Unknown, reader) {}
+
+template <typename T>
+CADMeshTemplate<T>::CADMeshTemplate(G4String file_name, File::Type file_type,
+                                    std::shared_ptr<File::Reader> reader) {
+  if (!reader->CanRead(file_type)) {
+    Exceptions::ReaderCantReadError(reader->GetName(), file_type, file_name);
+  }
+
+  file_name_ = file_name;
+  file_type_ = file_type;
+
+  scale_ = 1.0;
+
+  offset_ = G4ThreeVector();
+
+  verbose_ = 0;
 
   reader_ = reader;
 
-  reader_->Read(file_name_);
+  if (const char *directory = std::getenv("CADMESH_CACHE_DIR")) {
+    cache_directory_ = directory;
+  }
 }
 
 template <typename T>
@@ -1175,7 +1948,7 @@ CADMeshTemplate<T>::FromOBJ(G4String file_name,
 template <typename T> CADMeshTemplate<T>::~CADMeshTemplate() {}
 
 template <typename T> bool CADMeshTemplate<T>::IsValidForNavigation() {
-  return reader_->GetMesh()->IsValidForNavigation();
+  return GetMesh(0)->IsValidForNavigation();
 }
 
 template <typename T> G4String CADMeshTemplate<T>::GetFileName() {
@@ -1212,6 +1985,130 @@ template <typename T> void CADMeshTemplate<T>::SetOffset(G4ThreeVector offset) {
 template <typename T> G4ThreeVector CADMeshTemplate<T>::GetOffset() {
   return offset_;
 }
+
+template <typename T>
+void CADMeshTemplate<T>::SetCacheDirectory(G4String directory) {
+  cache_directory_ = directory;
+}
+
+template <typename T> G4String CADMeshTemplate<T>::GetCacheDirectory() {
+  return cache_directory_;
+}
+
+// The file is read on first use, so that the scale, offset and cache
+// directory are known: a cached file is not read at all.
+template <typename T> Meshes CADMeshTemplate<T>::GetMeshes() {
+  if (!meshes_.empty() && meshes_scale_ == scale_ &&
+      meshes_offset_ == offset_) {
+    return meshes_;
+  }
+
+  meshes_.clear();
+  meshes_scale_ = scale_;
+  meshes_offset_ = offset_;
+
+  std::shared_ptr<File::MeshCache> cache = nullptr;
+  uint64_t key = 0;
+
+  if (cache_directory_ != "") {
+    File::MappedFile file(file_name_);
+
+    if (file.IsOpen()) {
+      cache = std::make_shared<File::MeshCache>(cache_directory_);
+      key = File::MeshCache::Key(file.Data(), reader_->GetName(), scale_,
+                                 offset_);
+
+      if (cache->Load(key, meshes_)) {
+        if (verbose_ > 0) {
+          G4cout << "CADMesh: " << file_name_ << " loaded from "
+                 << cache->FilePath(key) << G4endl;
+        }
+
+        return meshes_;
+      }
+    }
+  }
+
+  Read();
+
+  for (auto mesh : reader_->GetMeshes()) {
+    meshes_.push_back(Transform(mesh));
+  }
+
+  if (cache && cache->Save(key, meshes_) && verbose_ > 0) {
+    G4cout << "CADMesh: " << file_name_ << " cached in "
+           << cache->FilePath(key) << G4endl;
+  }
+
+  return meshes_;
+}
+
+template <typename T>
+std::shared_ptr<Mesh> CADMeshTemplate<T>::GetMesh(size_t index) {
+  auto meshes = GetMeshes();
+
+  if (index < meshes.size()) {
+    return meshes[index];
+  }
+
+  Exceptions::MeshNotFound("CADMeshTemplate::GetMesh", index);
+
+  return nullptr;
+}
+
+template <typename T>
+std::shared_ptr<Mesh> CADMeshTemplate<T>::GetMesh(G4String name,
+                                                  G4bool exact) {
+  for (auto mesh : GetMeshes()) {
+    if (exact) {
+      if (mesh->GetName() == name)
+        return mesh;
+    }
+
+    else {
+      if (mesh->GetName().find(name) != std::string::npos)
+        return mesh;
+    }
+  }
+
+  Exceptions::MeshNotFound("CADMeshTemplate::GetMesh", name);
+
+  return nullptr;
+}
+
+template <typename T> void CADMeshTemplate<T>::Read() {
+  if (read_) {
+    return;
+  }
+
+  reader_->Read(file_name_);
+  read_ = true;
+}
+
+// Without scale and offset, the triangles of the reader are shared.
+template <typename T>
+std::shared_ptr<Mesh>
+CADMeshTemplate<T>::Transform(std::shared_ptr<Mesh> mesh) {
+  if (scale_ == 1.0 && offset_ == G4ThreeVector()) {
+    return mesh;
+  }
+
+  Triangles triangles;
+  triangles.reserve(mesh->GetTriangles().size());
+
+  for (auto triangle : mesh->GetTriangles()) {
+    auto a = triangle->GetVertex(0) * scale_ + offset_;
+    auto b = triangle->GetVertex(1) * scale_ + offset_;
+    auto c = triangle->GetVertex(2) * scale_ + offset_;
+
+    triangles.push_back(new G4TriangularFacet(a, b, c, ABSOLUTE));
+  }
+
+  auto transformed = Mesh::New(triangles, mesh->GetName());
+  transformed->SetOwnsTriangles(true);
+
+  return transformed;
+}
 }
 
 namespace CADMesh {
@@ -1282,8 +2179,8 @@ G4VSolid *TessellatedMesh::GetSolid(G4String name, G4bool exact) {
 std::vector<G4VSolid *> TessellatedMesh::GetSolids() {
   std::vector<G4VSolid *> solids;
 
-  for (auto mesh : reader_->GetMeshes()) {
-    solids.push_back(GetTessellatedSolid(mesh));
+  for (auto mesh : GetMeshes()) {
+    solids.push_back(BuildSolid(mesh));
   }
 
   return solids;
@@ -1294,8 +2191,8 @@ G4AssemblyVolume *TessellatedMesh::GetAssembly() {
     return assembly_;
   }
 
-  for (auto mesh : reader_->GetMeshes()) {
-    auto solid = GetTessellatedSolid(mesh);
+  for (auto mesh : GetMeshes()) {
+    auto solid = BuildSolid(mesh);
 
     G4Material *material = nullptr;
 
@@ -1316,32 +2213,38 @@ G4TessellatedSolid *TessellatedMesh::GetTessellatedSolid() {
 }
 
 G4TessellatedSolid *TessellatedMesh::GetTessellatedSolid(G4int index) {
-  return GetTessellatedSolid(reader_->GetMesh(index));
+  return BuildSolid(GetMesh(index));
 }
 
 G4TessellatedSolid *TessellatedMesh::GetTessellatedSolid(G4String name,
                                                          G4bool exact) {
-  return GetTessellatedSolid(reader_->GetMesh(name, exact));
+  return BuildSolid(GetMesh(name, exact));
 }
 
 G4TessellatedSolid *
 TessellatedMesh::GetTessellatedSolid(std::shared_ptr<Mesh> mesh) {
+  return BuildSolid(mesh);
+}
+
+// The mesh is already scaled and offset.
+G4TessellatedSolid *TessellatedMesh::BuildSolid(std::shared_ptr<Mesh> mesh) {
   auto volume_solid = new G4TessellatedSolid(mesh->GetName());
 
+  // the solid owns its facets, a reversed facet is built flipped
   for (auto triangle : mesh->GetTriangles()) {
-    auto a = triangle->GetVertex(0) * scale_ + offset_;
-    auto b = triangle->GetVertex(1) * scale_ + offset_;
-    auto c = triangle->GetVertex(2) * scale_ + offset_;
-
-    auto t = new G4TriangularFacet(a, b, c, ABSOLUTE);
+    G4VFacet *t = nullptr;
 
     if (reverse_) {
-      volume_solid->AddFacet((G4VFacet *)t->GetFlippedFacet());
+      t = new G4TriangularFacet(triangle->GetVertex(0), triangle->GetVertex(2),
+                                triangle->GetVertex(1), ABSOLUTE);
     }
 
     else {
-      volume_solid->AddFacet((G4VFacet *)t);
+      t = new G4TriangularFacet(triangle->GetVertex(0), triangle->GetVertex(1),
+                                triangle->GetVertex(2), ABSOLUTE);
     }
+
+    volume_solid->AddFacet(t);
   }
 
   volume_solid->SetSolidClosed(true);
@@ -1384,6 +2287,92 @@ G4AssemblyVolume *TetrahedralMesh::GetAssembly() {
 
   assembly_ = new G4AssemblyVolume();
 
+  Tetrahedralize();
+
+  G4RotationMatrix *element_rotation = new G4RotationMatrix();
+  G4ThreeVector element_position = G4ThreeVector();
+  G4Transform3D assembly_transform = G4Translate3D();
+
+  for (int i = 0; i < out_->numberoftetrahedra; i++) {
+    int index_offset = i * 4;
+
+    G4ThreeVector p1 = GetTetPoint(index_offset);
+    G4ThreeVector p2 = GetTetPoint(index_offset + 1);
+    G4ThreeVector p3 = GetTetPoint(index_offset + 2);
+    G4ThreeVector p4 = GetTetPoint(index_offset + 3);
+
+    G4String tet_name =
+        file_name_ + G4String("_tet_") + G4UIcommand::ConvertToString(i);
+
+    auto tet_solid =
+        new G4Tet(tet_name + G4String("_solid"), p1, p2, p3, p4, 0);
+
+    auto tet_logical = new G4LogicalVolume(
+        tet_solid, material_, tet_name + G4String("_logical"), 0, 0, 0);
+
+    assembly_->AddPlacedVolume(tet_logical, element_position, element_rotation);
+  }
+
+  return assembly_;
+}
+
+G4PVParameterised *
+TetrahedralMesh::GetParameterisedVolume(G4LogicalVolume *mother,
+                                        G4String name) {
+  Tetrahedralize();
+
+  if (out_->numberoftetrahedra <= 0) {
+    G4Exception("TetrahedralMesh::GetParameterisedVolume",
+                "The mesh has 0 tetrahedra.", FatalException,
+                "The file may be empty.");
+    return nullptr;
+  }
+
+  if (name == "") {
+    name = file_name_ + "_tets";
+  }
+
+  // The same points as GetTetPoint, scaled and offset once.
+  std::vector<G4double> x, y, z;
+  x.reserve(out_->numberofpoints);
+  y.reserve(out_->numberofpoints);
+  z.reserve(out_->numberofpoints);
+
+  for (int i = 0; i < out_->numberofpoints; i++) {
+    x.push_back(out_->pointlist[i * 3] * scale_ - offset_.x());
+    y.push_back(out_->pointlist[i * 3 + 1] * scale_ - offset_.y());
+    z.push_back(out_->pointlist[i * 3 + 2] * scale_ - offset_.z());
+  }
+
+  std::vector<uint32_t> indices;
+  indices.reserve(4 * out_->numberoftetrahedra);
+
+  for (int i = 0; i < out_->numberoftetrahedra; i++) {
+    for (int j = 0; j < 4; j++) {
+      indices.push_back(out_->tetrahedronlist[i * 4 + j]);
+    }
+  }
+
+  auto parameterisation = new TetrahedralParameterisation(
+      std::move(x), std::move(y), std::move(z), std::move(indices));
+
+  auto tet_solid = new ParameterisedTet(
+      name + "_solid", parameterisation->GetPoint(0, 0),
+      parameterisation->GetPoint(0, 1), parameterisation->GetPoint(0, 2),
+      parameterisation->GetPoint(0, 3), 0);
+
+  auto tet_logical =
+      new G4LogicalVolume(tet_solid, material_, name + "_logical", 0, 0, 0);
+
+  return new G4PVParameterised(name, tet_logical, mother, kUndefined,
+                               out_->numberoftetrahedra, parameterisation);
+}
+
+void TetrahedralMesh::Tetrahedralize() {
+  if (out_) {
+    return;
+  }
+
   in_ = std::make_shared<tetgenio>();
   out_ = std::make_shared<tetgenio>();
 
@@ -1417,32 +2406,6 @@ G4AssemblyVolume *TetrahedralMesh::GetAssembly() {
 
     tetrahedralize(behavior, in_.get(), out_.get());
   }
-
-  G4RotationMatrix *element_rotation = new G4RotationMatrix();
-  G4ThreeVector element_position = G4ThreeVector();
-  G4Transform3D assembly_transform = G4Translate3D();
-
-  for (int i = 0; i < out_->numberoftetrahedra; i++) {
-    int index_offset = i * 4;
-
-    G4ThreeVector p1 = GetTetPoint(index_offset);
-    G4ThreeVector p2 = GetTetPoint(index_offset + 1);
-    G4ThreeVector p3 = GetTetPoint(index_offset + 2);
-    G4ThreeVector p4 = GetTetPoint(index_offset + 3);
-
-    G4String tet_name =
-        file_name_ + G4String("_tet_") + G4UIcommand::ConvertToString(i);
-
-    auto tet_solid =
-        new G4Tet(tet_name + G4String("_solid"), p1, p2, p3, p4, 0);
-
-    auto tet_logical = new G4LogicalVolume(
-        tet_solid, material_, tet_name + G4String("_logical"), 0, 0, 0);
-
-    assembly_->AddPlacedVolume(tet_logical, element_position, element_rotation);
-  }
-
-  return assembly_;
 }
 
 G4ThreeVector TetrahedralMesh::GetTetPoint(G4int index_offset) {
@@ -1454,6 +2417,42 @@ G4ThreeVector TetrahedralMesh::GetTetPoint(G4int index_offset) {
       out_->pointlist[out_->tetrahedronlist[index_offset] * 3 + 2] * scale_ -
           offset_.z());
 }
+
+TetrahedralParameterisation::TetrahedralParameterisation(
+    std::vector<G4double> x, std::vector<G4double> y, std::vector<G4double> z,
+    std::vector<uint32_t> indices)
+    : x_(std::move(x)), y_(std::move(y)), z_(std::move(z)),
+      indices_(std::move(indices)) {}
+
+void TetrahedralParameterisation::ComputeTransformation(
+    const G4int /*copy_number*/, G4VPhysicalVolume *physical) const {
+  physical->SetTranslation(G4ThreeVector());
+  physical->SetRotation(nullptr);
+}
+
+void TetrahedralParameterisation::ComputeTet(G4Tet &tet,
+                                             const G4int copy_number) const {
+  tet.SetVertices(GetPoint(copy_number, 0), GetPoint(copy_number, 1),
+                  GetPoint(copy_number, 2), GetPoint(copy_number, 3));
+}
+
+G4ThreeVector TetrahedralParameterisation::GetPoint(size_t tetrahedron,
+                                                    size_t corner) const {
+  auto index = indices_[4 * tetrahedron + corner];
+
+  return G4ThreeVector(x_[index], y_[index], z_[index]);
+}
+
+void ParameterisedTet::ComputeDimensions(
+    G4VPVParameterisation *parameterisation, const G4int copy_number,
+    const G4VPhysicalVolume * /*physical*/) {
+  static_cast<TetrahedralParameterisation *>(parameterisation)
+      ->ComputeTet(*this, copy_number);
+}
+
+G4VSolid *ParameterisedTet::Clone() const {
+  return new ParameterisedTet(*this);
+}
 }
 #endif
 
@@ -1556,24 +2555,32 @@ public:
   G4bool Read(G4String filepath);
   G4bool CanRead(Type file_type);
 
+  static G4bool IsBinary(std::string_view data);
+
 protected:
-  CADMeshLexerStateDefinition(StartSolid);
-  CADMeshLexerStateDefinition(EndSolid);
+  G4bool ReadBinary(std::string_view data);
+  G4bool ReadASCII(std::string_view data);
 
-  CADMeshLexerStateDefinition(StartFacet);
-  CADMeshLexerStateDefinition(EndFacet);
+  // The ASCII records are read in place from the mapped file, keyword by
+  // keyword, without tokens.
+  class ASCIIParser {
+  public:
+    ASCIIParser(std::string_view data) : data_(data) {}
 
-  CADMeshLexerStateDefinition(StartVertices);
-  CADMeshLexerStateDefinition(EndVertices);
+    bool Keyword(std::string_view keyword);
+    std::string_view RemainderOfLine();
+    bool Facet(G4ThreeVector (&vertices)[3]);
+    bool ThreeVector(G4ThreeVector &vector);
 
-  CADMeshLexerStateDefinition(Vertex);
+    void Fail(std::string message);
 
-  CADMeshLexerStateDefinition(ThreeVector);
+  private:
+    void SkipSpace();
 
-  std::shared_ptr<Mesh> ParseMesh(Items items);
-  G4TriangularFacet *ParseFacet(Items items);
-  G4TriangularFacet *ParseVertices(Items items);
-  G4ThreeVector ParseThreeVector(Items items);
+    std::string_view data_;
+    size_t position_ = 0;
+    size_t line_ = 1;
+  };
 };
 }
 }
@@ -1598,9 +2605,9 @@ protected:
   CADMeshLexerStateDefinition(Facet);
   CADMeshLexerStateDefinition(Object);
 
-  std::shared_ptr<Mesh> ParseMesh(Items items);
-  G4ThreeVector ParseVertex(Items items);
-  G4TriangularFacet *ParseFacet(Items items, G4bool quad);
+  std::shared_ptr<Mesh> ParseMesh(const Items &items);
+  G4ThreeVector ParseVertex(const Items &items);
+  G4TriangularFacet *ParseFacet(const Items &items, G4bool quad);
 
 private:
   Points vertices_;
@@ -1616,6 +2623,36 @@ CADMeshLexerToken(Header);
 CADMeshLexerToken(Element);
 CADMeshLexerToken(Property);
 
+enum PLYType {
+  PLYUnknown,
+  PLYChar,
+  PLYUChar,
+  PLYShort,
+  PLYUShort,
+  PLYInt,
+  PLYUInt,
+  PLYFloat,
+  PLYDouble,
+};
+
+PLYType PLYTypeFromName(const std::string &name);
+size_t PLYTypeSize(PLYType type);
+double PLYScalar(const char *data, PLYType type, bool swap);
+
+struct PLYProperty {
+  std::string name;
+
+  PLYType type;
+  PLYType count_type; // PLYUnknown unless a list.
+};
+
+struct PLYElement {
+  std::string name;
+  size_t count;
+
+  std::vector<PLYProperty> properties;
+};
+
 class PLYReader : public Reader {
 public:
   PLYReader() : Reader("PLYReader"){};
@@ -1623,7 +2660,11 @@ public:
   G4bool Read(G4String filepath);
   G4bool CanRead(Type file_type);
 
+  static G4bool IsBinary(std::string_view data);
+
 protected:
+  G4bool ReadBinary(std::string_view data);
+
   CADMeshLexerStateDefinition(StartHeader);
   CADMeshLexerStateDefinition(EndHeader);
 
@@ -1634,294 +2675,284 @@ protected:
   CADMeshLexerStateDefinition(Vertex);
   CADMeshLexerStateDefinition(Facet);
 
-  void ParseHeader(Items items);
-
-  std::shared_ptr<Mesh> ParseMesh(Items vertex_items, Items face_items);
-  G4ThreeVector ParseVertex(Items items);
-  G4TriangularFacet *ParseFacet(Items items, Points vertices);
-
-  size_t vertex_count_ = 0;
-  size_t facet_count_ = 0;
-
-  size_t x_index_ = 0;
-  size_t y_index_ = 0;
-  size_t z_index_ = 0;
-
-  size_t facet_index_ = 0;
-};
-}
-}
-
-namespace CADMesh {
-
-namespace File {
-
-State *STLReader::CADMeshLexerState(StartSolid) {
-  if (DoesNotMatchExactly("solid"))
-    Error("STL files start with 'solid'.");
-
-  SkipWhiteSpace();
-
-  ManyLetters();
-
-  StartOfA(Solid);
-
-  SkipLineBreak();
-  NextState(StartFacet);
-}
-
-State *STLReader::CADMeshLexerState(EndSolid) {
-  SkipWhiteSpace();
-  SkipLineBreaks();
-  SkipWhiteSpace();
-
-  if (DoesNotMatchExactly("endsolid"))
-    Error("STL files end with 'endsolid'.");
-
-  Skip();
-  EndOfA(Solid);
-
-  FinalState();
-}
-
-State *STLReader::CADMeshLexerState(StartFacet) {
-  SkipWhiteSpace();
-  SkipLineBreaks();
-  SkipWhiteSpace();
-
-  if (DoesNotMatchExactly("facet normal"))
-    Error("Facets are indicated by the tag 'facet normal'.");
+  void ParseHeader(const Items &items);
 
-  SkipWhiteSpace();
+  std::shared_ptr<Mesh> ParseMesh(const Items &vertex_items,
+                                  const Items &face_items);
+  G4ThreeVector ParseVertex(const Items &items);
+  G4TriangularFacet *ParseFacet(const Items &items, const Points &vertices);
 
-  StartOfA(Facet);
+  size_t vertex_count_ = 0;
+  size_t facet_count_ = 0;
 
-  SkipLine();
+  size_t x_index_ = 0;
+  size_t y_index_ = 0;
+  size_t z_index_ = 0;
 
-  NextState(StartVertices);
+  size_t facet_index_ = 0;
+};
+}
 }
 
-State *STLReader::CADMeshLexerState(EndFacet) {
-  SkipWhiteSpace();
-  SkipLineBreaks();
-  SkipWhiteSpace();
+namespace CADMesh {
 
-  if (DoesNotMatchExactly("endfacet"))
-    Error("The end of a facets is indicated by the tag 'endfacet'.");
+namespace File {
 
-  SkipWhiteSpace();
-  SkipLineBreak();
+G4bool STLReader::Read(G4String filepath) {
+  {
+    MappedFile file(filepath);
 
-  EndOfA(Facet);
+    if (!file.IsOpen()) {
+      Exceptions::FileNotFound("STLReader::Read", filepath);
+      return false;
+    }
 
-  TryState(StartFacet);
+    if (IsBinary(file.Data())) {
+      return ReadBinary(file.Data());
+    }
 
-  NextState(EndSolid);
+    return ReadASCII(file.Data());
+  }
 }
 
-State *STLReader::CADMeshLexerState(StartVertices) {
-  SkipWhiteSpace();
-  SkipLineBreaks();
-  SkipWhiteSpace();
+G4bool STLReader::CanRead(Type file_type) { return (file_type == STL); }
 
-  if (DoesNotMatchExactly("outer loop"))
-    Error("The start of the vertices is indicated by the tag 'outer loop'.");
+// Binary STL: an 80 byte header, the number of facets, then 50 bytes a
+// facet (normal, three vertices, attribute). Some exporters start the
+// header with 'solid' as well, so the size is checked first, then the
+// null bytes that an ASCII file does not have. An ASCII file may start
+// with a byte order mark and white space.
+G4bool STLReader::IsBinary(std::string_view data) {
+  if (data.size() >= 84) {
+    uint64_t count = FromBytes<uint32_t>(data.data() + 80, IsHostBigEndian());
+
+    if (84 + 50 * count == data.size()) {
+      return true;
+    }
+  }
 
-  SkipWhiteSpace();
-  SkipLineBreak();
+  if (data.substr(0, 512).find('\0') != std::string_view::npos) {
+    return true;
+  }
 
-  StartOfA(Vertices);
+  data = SkipByteOrderMark(data);
 
-  NextState(Vertex);
+  auto first = data.find_first_not_of(" \t\r\n");
+
+  return first == std::string_view::npos ||
+         data.compare(first, 5, "solid") != 0;
 }
 
-State *STLReader::CADMeshLexerState(EndVertices) {
-  SkipWhiteSpace();
-  SkipLineBreaks();
-  SkipWhiteSpace();
+G4bool STLReader::ReadBinary(std::string_view data) {
+  bool swap = IsHostBigEndian();
 
-  if (DoesNotMatchExactly("endloop"))
-    Error("The end of the vertices is indicated by the tag 'endloop'.");
+  uint64_t count = FromBytes<uint32_t>(data.data() + 80, swap);
 
-  SkipWhiteSpace();
-  SkipLineBreak();
+  if (count == 0) {
+    Exceptions::ParserError("STLReader::ReadBinary",
+                            "The STL file appears to be empty.");
+    return false;
+  }
 
-  EndOfA(Vertices);
+  if (84 + 50 * count > data.size()) {
+    Exceptions::ParserError("STLReader::ReadBinary",
+                            "The STL file appears to be missing facets.");
+    return false;
+  }
 
-  NextState(EndFacet);
-}
+  Triangles triangles;
+  triangles.reserve(count);
 
-State *STLReader::CADMeshLexerState(Vertex) {
-  SkipWhiteSpace();
-  SkipLineBreaks();
-  SkipWhiteSpace();
+  const char *facet = data.data() + 84;
 
-  if (DoesNotMatchExactly("vertex"))
-    Error("A vertex is indicated by the tag 'vertex'.");
+  for (uint64_t i = 0; i < count; i++, facet += 50) {
+    G4ThreeVector vertices[3];
 
-  SkipWhiteSpace();
+    for (size_t j = 0; j < 3; j++) {
+      const char *vertex = facet + 12 * (j + 1);
+
+      vertices[j] = G4ThreeVector(FromBytes<float>(vertex, swap),
+                                  FromBytes<float>(vertex + 4, swap),
+                                  FromBytes<float>(vertex + 8, swap));
+    }
+
+    triangles.push_back(new G4TriangularFacet(vertices[0], vertices[1],
+                                              vertices[2], ABSOLUTE));
+  }
+
+  AddMesh(Mesh::New(triangles));
 
-  NextState(ThreeVector);
+  return true;
 }
 
-State *STLReader::CADMeshLexerState(ThreeVector) {
-  SkipWhiteSpace();
+// solid name
+//   facet normal nx ny nz
+//     outer loop
+//       vertex x y z (three times)
+//     endloop
+//   endfacet (once a facet)
+// endsolid name
+G4bool STLReader::ReadASCII(std::string_view data) {
+  ASCIIParser parser(SkipByteOrderMark(data));
 
-  StartOfA(ThreeVector);
+  if (!parser.Keyword("solid")) {
+    parser.Fail("STL files start with 'solid'.");
+    return false;
+  }
 
-  if (NotANumber())
-    Error("First number in three vector not found.");
+  G4String name(parser.RemainderOfLine());
 
-  ThisIsA(Number);
-  SkipWhiteSpace();
+  Triangles triangles;
+  G4bool valid = true;
 
-  if (NotANumber())
-    Error("Second number in three vector not found.");
+  while (valid && parser.Keyword("facet")) {
+    G4ThreeVector vertices[3];
 
-  ThisIsA(Number);
-  SkipWhiteSpace();
+    valid = parser.Facet(vertices);
 
-  if (NotANumber())
-    Error("Third number in three vector not found.");
+    if (valid) {
+      triangles.push_back(new G4TriangularFacet(vertices[0], vertices[1],
+                                                vertices[2], ABSOLUTE));
+    }
+  }
 
-  ThisIsA(Number);
-  EndOfA(ThreeVector);
+  if (valid && !parser.Keyword("endsolid")) {
+    parser.Fail("STL files end with 'endsolid'.");
+    valid = false;
+  }
 
-  SkipWhiteSpace();
+  if (!valid) {
+    for (auto triangle : triangles)
+      delete triangle;
 
-  if (DidNotSkipLineBreak())
-    Error("Expecting a new line at the end of a three vector.");
+    return false;
+  }
 
-  TryState(StartVertices);
+  if (triangles.size() == 0) {
+    Exceptions::ParserError("STLReader::ReadASCII",
+                            "The mesh appears to be empty.");
+    return false;
+  }
 
-  TryState(Vertex);
+  AddMesh(Mesh::New(triangles, name));
 
-  NextState(EndVertices);
+  return true;
 }
 
-G4bool STLReader::Read(G4String filepath) {
-  auto items = RunLexer(filepath, StartSolid);
+// The rest of a facet, after its 'facet' keyword.
+bool STLReader::ASCIIParser::Facet(G4ThreeVector (&vertices)[3]) {
+  if (!Keyword("normal")) {
+    Fail("Facets are indicated by the tag 'facet normal'.");
+    return false;
+  }
 
-  if (items.size() == 0) {
-    Exceptions::ParserError("STLReader::Read",
-                            "The STL file appears to be empty.");
+  // the normal is computed from the vertices
+  RemainderOfLine();
+
+  if (!Keyword("outer") || !Keyword("loop")) {
+    Fail("The start of the vertices is indicated by the tag 'outer loop'.");
+    return false;
   }
 
-  for (auto item : items) {
-    if (item.children.size() == 0) {
-      std::stringstream error;
-      error << "The mesh appears to be empty."
-            << "Error around line " << item.line << ".";
+  for (size_t i = 0; i < 3; i++) {
+    if (!Keyword("vertex")) {
+      Fail("STL files expect exactly 3 vertices for a triangular facet.");
+      return false;
+    }
 
-      Exceptions::ParserError("STLReader::Read", error.str());
+    if (!ThreeVector(vertices[i])) {
+      Fail("Three vectors in STL files require exactly 3 numbers.");
+      return false;
     }
+  }
 
-    auto mesh = ParseMesh(item.children);
+  if (!Keyword("endloop")) {
+    Fail("The end of the vertices is indicated by the tag 'endloop'.");
+    return false;
+  }
 
-    auto name = G4String(item.value);
-    AddMesh(Mesh::New(mesh, name));
+  if (!Keyword("endfacet")) {
+    Fail("The end of a facets is indicated by the tag 'endfacet'.");
+    return false;
   }
 
   return true;
 }
 
-G4bool STLReader::CanRead(Type file_type) { return (file_type == STL); }
-
-std::shared_ptr<Mesh> STLReader::ParseMesh(Items items) {
-  Triangles triangles;
+void STLReader::ASCIIParser::SkipSpace() {
+  while (position_ < data_.size()) {
+    char c = data_[position_];
 
-  for (auto item : items) {
-    if (item.children.size() == 0) {
-      std::stringstream error;
-      error << "The facet appears to be empty."
-            << "Error around line " << item.line << ".";
+    if (c == '\n')
+      line_++;
 
-      Exceptions::ParserError("STLReader::Mesh", error.str());
-    }
+    else if (c != ' ' && c != '\t' && c != '\r')
+      break;
 
-    triangles.push_back(ParseFacet(item.children));
+    position_++;
   }
-
-  return Mesh::New(triangles);
 }
 
-G4TriangularFacet *STLReader::ParseFacet(Items items) {
-  Triangles triangles;
-
-  for (auto item : items) {
-    if (item.children.size() == 0) {
-      std::stringstream error;
-      error << "The vertex appears to be empty."
-            << "Error around line " << item.line << ".";
-
-      Exceptions::ParserError("STLReader::ParseFacet", error.str());
-    }
+// The keyword is followed by a white space or the end of the file.
+bool STLReader::ASCIIParser::Keyword(std::string_view keyword) {
+  SkipSpace();
 
-    triangles.push_back(ParseVertices(item.children));
-  }
+  if (data_.compare(position_, keyword.size(), keyword) != 0)
+    return false;
 
-  if (triangles.size() != 1) {
-    std::stringstream error;
-    error << "STL files expect exactly 1 triangle per facet.";
+  size_t end = position_ + keyword.size();
 
-    if (items.size() != 0) {
-      error << "Error around line " << items[0].line << ".";
-    }
+  if (end < data_.size() && !std::isspace((unsigned char)data_[end]))
+    return false;
 
-    Exceptions::ParserError("STLReader::ParseFacet", error.str());
-  }
+  position_ = end;
 
-  return triangles[0];
+  return true;
 }
 
-G4TriangularFacet *STLReader::ParseVertices(Items items) {
-  std::vector<G4ThreeVector> vertices;
+std::string_view STLReader::ASCIIParser::RemainderOfLine() {
+  size_t end = data_.find_first_of("\r\n", position_);
 
-  for (auto item : items) {
-    if (item.children.size() == 0) {
-      std::stringstream error;
-      error << "The vertex appears to be empty."
-            << "Error around line " << item.line << ".";
+  if (end == std::string_view::npos)
+    end = data_.size();
 
-      Exceptions::ParserError("STLReader::ParseVertices", error.str());
-    }
+  auto rest = data_.substr(position_, end - position_);
+  position_ = end;
 
-    vertices.push_back(ParseThreeVector(item.children));
-  }
+  size_t first = rest.find_first_not_of(" \t");
 
-  if (vertices.size() != 3) {
-    std::stringstream error;
-    error << "STL files expect exactly 3 vertices for a triangular facet. ";
+  if (first == std::string_view::npos)
+    return std::string_view();
 
-    if (items.size() != 0) {
-      error << "Error around line " << items[0].line << ".";
-    }
+  return rest.substr(first, rest.find_last_not_of(" \t") - first + 1);
+}
 
-    Exceptions::ParserError("STLReader::ParseVertices", error.str());
-  }
+bool STLReader::ASCIIParser::ThreeVector(G4ThreeVector &vector) {
+  double numbers[3];
 
-  return new G4TriangularFacet(vertices[0], vertices[1], vertices[2], ABSOLUTE);
-}
+  for (size_t i = 0; i < 3; i++) {
+    SkipSpace();
 
-G4ThreeVector STLReader::ParseThreeVector(Items items) {
-  std::vector<double> numbers;
+    const char *first = data_.data() + position_;
+    const char *last = data_.data() + data_.size();
+    const char *end = ParseDouble(first, last, numbers[i]);
+
+    if (!end)
+      return false;
 
-  for (auto item : items) {
-    numbers.push_back((double)atof(item.value.c_str()));
+    position_ += end - first;
   }
 
-  if (numbers.size() != 3) {
-    std::stringstream error;
-    error << "Three vectors in STL files require exactly 3 numbers";
+  vector = G4ThreeVector(numbers[0], numbers[1], numbers[2]);
 
-    if (items.size() != 0) {
-      error << "Error around line " << items[0].line << ".";
-    }
+  return true;
+}
 
-    Exceptions::ParserError("STLReader::ParseThreeVector", error.str());
-  }
+void STLReader::ASCIIParser::Fail(std::string message) {
+  std::stringstream error;
+  error << message << " Error around line " << line_ << ".";
 
-  return G4ThreeVector(numbers[0], numbers[1], numbers[2]);
+  Exceptions::ParserError("STLReader::ReadASCII", error.str());
 }
 }
 }
@@ -2086,7 +3117,7 @@ G4bool OBJReader::Read(G4String filepath) {
                             "The OBJ file appears to be empty.");
   }
 
-  for (auto item : items) {
+  for (const auto &item : items) {
     if (item.children.size() == 0) {
       continue;
     }
@@ -2111,10 +3142,10 @@ G4bool OBJReader::Read(G4String filepath) {
 
 G4bool OBJReader::CanRead(Type file_type) { return (file_type == OBJ); }
 
-std::shared_ptr<Mesh> OBJReader::ParseMesh(Items items) {
+std::shared_ptr<Mesh> OBJReader::ParseMesh(const Items &items) {
   Triangles facets;
 
-  for (auto item : items) {
+  for (const auto &item : items) {
     if (item.token != VertexToken) {
       continue;
     }
@@ -2130,7 +3161,7 @@ std::shared_ptr<Mesh> OBJReader::ParseMesh(Items items) {
     vertices_.push_back(ParseVertex(item.children));
   }
 
-  for (auto item : items) {
+  for (const auto &item : items) {
     if (item.token != FacetToken) {
       continue;
     }
@@ -2153,11 +3184,11 @@ std::shared_ptr<Mesh> OBJReader::ParseMesh(Items items) {
   return Mesh::New(facets);
 }
 
-G4ThreeVector OBJReader::ParseVertex(Items items) {
+G4ThreeVector OBJReader::ParseVertex(const Items &items) {
   std::vector<double> numbers;
 
-  for (auto item : items) {
-    numbers.push_back((double)atof(item.value.c_str()));
+  for (const auto &item : items) {
+    numbers.push_back(ParseDouble(item.value));
   }
 
   if (numbers.size() != 3) {
@@ -2174,11 +3205,11 @@ G4ThreeVector OBJReader::ParseVertex(Items items) {
   return G4ThreeVector(numbers[0], numbers[1], numbers[2]);
 }
 
-G4TriangularFacet *OBJReader::ParseFacet(Items items, G4bool quad) {
+G4TriangularFacet *OBJReader::ParseFacet(const Items &items, G4bool quad) {
   std::vector<int> indices;
 
-  for (auto item : items) {
-    indices.push_back((int)atoi(item.value.c_str()));
+  for (const auto &item : items) {
+    indices.push_back(ParseInt(item.value));
   }
 
   if (indices.size() < 3) {
@@ -2379,6 +3410,19 @@ State *PLYReader::CADMeshLexerState(Facet) {
 }
 
 G4bool PLYReader::Read(G4String filepath) {
+  {
+    MappedFile file(filepath);
+
+    if (!file.IsOpen()) {
+      Exceptions::FileNotFound("PLYReader::Read", filepath);
+      return false;
+    }
+
+    if (IsBinary(file.Data())) {
+      return ReadBinary(file.Data());
+    }
+  }
+
   auto lexer = Lexer(filepath, new StartHeaderState);
   auto items = lexer.GetItems();
 
@@ -2425,7 +3469,296 @@ G4bool PLYReader::Read(G4String filepath) {
 
 G4bool PLYReader::CanRead(Type file_type) { return (file_type == PLY); }
 
-void PLYReader::ParseHeader(Items items) {
+PLYType PLYTypeFromName(const std::string &name) {
+  static const std::map<std::string, PLYType> types = {
+      {"char", PLYChar},     {"int8", PLYChar},     {"uchar", PLYUChar},
+      {"uint8", PLYUChar},   {"short", PLYShort},   {"int16", PLYShort},
+      {"ushort", PLYUShort}, {"uint16", PLYUShort}, {"int", PLYInt},
+      {"int32", PLYInt},     {"uint", PLYUInt},     {"uint32", PLYUInt},
+      {"float", PLYFloat},   {"float32", PLYFloat}, {"double", PLYDouble},
+      {"float64", PLYDouble}};
+
+  auto type = types.find(name);
+
+  if (type == types.end()) {
+    return PLYUnknown;
+  }
+
+  return type->second;
+}
+
+size_t PLYTypeSize(PLYType type) {
+  switch (type) {
+  case PLYChar:
+  case PLYUChar:
+    return 1;
+  case PLYShort:
+  case PLYUShort:
+    return 2;
+  case PLYInt:
+  case PLYUInt:
+  case PLYFloat:
+    return 4;
+  case PLYDouble:
+    return 8;
+  default:
+    return 0;
+  }
+}
+
+double PLYScalar(const char *data, PLYType type, bool swap) {
+  switch (type) {
+  case PLYChar:
+    return FromBytes<int8_t>(data, swap);
+  case PLYUChar:
+    return FromBytes<uint8_t>(data, swap);
+  case PLYShort:
+    return FromBytes<int16_t>(data, swap);
+  case PLYUShort:
+    return FromBytes<uint16_t>(data, swap);
+  case PLYInt:
+    return FromBytes<int32_t>(data, swap);
+  case PLYUInt:
+    return FromBytes<uint32_t>(data, swap);
+  case PLYFloat:
+    return FromBytes<float>(data, swap);
+  case PLYDouble:
+    return FromBytes<double>(data, swap);
+  default:
+    return 0.;
+  }
+}
+
+// Only the header is searched, not the body that follows it.
+G4bool PLYReader::IsBinary(std::string_view data) {
+  auto end_header = data.find("end_header");
+
+  if (end_header == std::string_view::npos) {
+    return false;
+  }
+
+  return data.substr(0, end_header).find("format binary_") !=
+         std::string_view::npos;
+}
+
+// The header is read line by line. The vertices, all scalars, are read
+// at fixed offsets; the faces, lists, are triangulated as fans. Other
+// elements and properties are skipped.
+G4bool PLYReader::ReadBinary(std::string_view data) {
+  auto end_header = data.find("end_header");
+  auto body = data.find('\n', end_header);
+
+  if (end_header == std::string_view::npos ||
+      body == std::string_view::npos) {
+    Exceptions::ParserError("PLYReader::ReadBinary",
+                            "The header appears to be invalid or missing.");
+    return false;
+  }
+
+  std::vector<PLYElement> elements;
+  bool big_endian = false;
+
+  std::istringstream header{std::string(data.substr(0, end_header))};
+  std::string line;
+
+  while (std::getline(header, line)) {
+    std::istringstream words(line);
+    std::string keyword;
+    words >> keyword;
+
+    if (keyword == "format") {
+      std::string format;
+      words >> format;
+
+      big_endian = (format == "binary_big_endian");
+    }
+
+    else if (keyword == "element") {
+      PLYElement element{"", 0, {}};
+      words >> element.name >> element.count;
+
+      elements.push_back(element);
+    }
+
+    else if (keyword == "property" && !elements.empty()) {
+      PLYProperty property{"", PLYUnknown, PLYUnknown};
+      std::string type;
+      words >> type;
+
+      bool is_list = (type == "list");
+
+      if (is_list) {
+        words >> type;
+        property.count_type = PLYTypeFromName(type);
+
+        words >> type;
+      }
+
+      property.type = PLYTypeFromName(type);
+      words >> property.name;
+
+      if (property.type == PLYUnknown ||
+          (is_list && property.count_type == PLYUnknown)) {
+        std::stringstream error;
+        error << "Unknown property type in header: " << line;
+
+        Exceptions::ParserError("PLYReader::ReadBinary", error.str());
+        return false;
+      }
+
+      elements.back().properties.push_back(property);
+    }
+  }
+
+  bool swap = (big_endian != IsHostBigEndian());
+
+  const char *position = data.data() + body + 1;
+  const char *last = data.data() + data.size();
+
+  Points vertices;
+  Triangles facets;
+
+  for (const auto &element : elements) {
+    if (element.name == "vertex") {
+      size_t stride = 0;
+      size_t offsets[3] = {0, 0, 0};
+      PLYType types[3] = {PLYUnknown, PLYUnknown, PLYUnknown};
+
+      for (const auto &property : element.properties) {
+        if (property.count_type != PLYUnknown) {
+          Exceptions::ParserError("PLYReader::ReadBinary",
+                                  "List properties of vertices are not "
+                                  "supported in binary PLY files.");
+          return false;
+        }
+
+        size_t axis = std::string("xyz").find(property.name);
+
+        if (property.name.size() == 1 && axis != std::string::npos) {
+          offsets[axis] = stride;
+          types[axis] = property.type;
+        }
+
+        stride += PLYTypeSize(property.type);
+      }
+
+      if (types[0] == PLYUnknown || types[1] == PLYUnknown ||
+          types[2] == PLYUnknown) {
+        Exceptions::ParserError(
+            "PLYReader::ReadBinary",
+            "The vertex x, y, z indices were not found in the header.");
+        return false;
+      }
+
+      // divided rather than multiplied, the count may be anything
+      if (element.count > static_cast<size_t>(last - position) / stride) {
+        Exceptions::ParserError("PLYReader::ReadBinary",
+                                "The PLY file appears to be missing vertices.");
+        return false;
+      }
+
+      vertices.reserve(element.count);
+
+      for (size_t i = 0; i < element.count; i++, position += stride) {
+        vertices.push_back(
+            G4ThreeVector(PLYScalar(position + offsets[0], types[0], swap),
+                          PLYScalar(position + offsets[1], types[1], swap),
+                          PLYScalar(position + offsets[2], types[2], swap)));
+      }
+
+      continue;
+    }
+
+    bool is_face = (element.name == "face");
+
+    if (is_face) {
+      facets.reserve(element.count);
+    }
+
+    for (size_t i = 0; i < element.count; i++) {
+      for (const auto &property : element.properties) {
+        size_t size = PLYTypeSize(property.type);
+        size_t count = 1;
+
+        if (property.count_type != PLYUnknown) {
+          size_t count_size = PLYTypeSize(property.count_type);
+
+          if (static_cast<size_t>(last - position) < count_size) {
+            position = nullptr;
+            break;
+          }
+
+          count = PLYScalar(position, property.count_type, swap);
+          position += count_size;
+        }
+
+        if (size > 0 && count > static_cast<size_t>(last - position) / size) {
+          position = nullptr;
+          break;
+        }
+
+        if (is_face && count >= 3 &&
+            (property.name == "vertex_indices" ||
+             property.name == "vertex_index")) {
+          size_t first = PLYScalar(position, property.type, swap);
+          size_t previous = PLYScalar(position + size, property.type, swap);
+
+          for (size_t j = 2; j < count; j++) {
+            size_t next = PLYScalar(position + j * size, property.type, swap);
+
+            if (first >= vertices.size() || previous >= vertices.size() ||
+                next >= vertices.size()) {
+              for (auto facet : facets)
+                delete facet;
+
+              Exceptions::ParserError(
+                  "PLYReader::ReadBinary",
+                  "A facet refers to a vertex not in the PLY file.");
+              return false;
+            }
+
+            facets.push_back(new G4TriangularFacet(
+                vertices[first], vertices[previous], vertices[next], ABSOLUTE));
+
+            previous = next;
+          }
+        }
+
+        position += size * count;
+      }
+
+      if (!position) {
+        for (auto facet : facets)
+          delete facet;
+
+        std::stringstream error;
+        error << "The PLY file appears to be missing " << element.name
+              << " elements.";
+
+        Exceptions::ParserError("PLYReader::ReadBinary", error.str());
+        return false;
+      }
+    }
+  }
+
+  if (vertices.size() == 0) {
+    Exceptions::ParserError("PLYReader::ReadBinary",
+                            "The PLY file appears to have no vertices.");
+    return false;
+  }
+
+  if (facets.size() == 0) {
+    Exceptions::ParserError("PLYReader::ReadBinary",
+                            "The PLY file appears to have no facets.");
+    return false;
+  }
+
+  AddMesh(Mesh::New(facets));
+
+  return true;
+}
+
+void PLYReader::ParseHeader(const Items &items) {
   if (items.size() != 1) {
     std::stringstream error;
     error << "The header appears to be invalid or missing."
@@ -2434,7 +3767,7 @@ void PLYReader::ParseHeader(Items items) {
     Exceptions::ParserError("PLYReader::ParseHeader", error.str());
   }
 
-  for (auto item : items[0].children) {
+  for (const auto &item : items[0].children) {
     if (item.token == ElementToken) {
       if (item.children.size() < 2) {
         std::stringstream error;
@@ -2448,10 +3781,10 @@ void PLYReader::ParseHeader(Items items) {
       if (item.children[0].token == WordToken &&
           item.children[1].token == NumberToken) {
         if (item.children[0].value == "vertex") {
-          vertex_count_ = atoi(item.children[1].value.c_str());
+          vertex_count_ = ParseInt(item.children[1].value);
 
           for (size_t i = 2; i < item.children.size(); i++) {
-            auto property = item.children[i];
+            const auto &property = item.children[i];
 
             if (property.children.size() > 1) {
               if (property.children[1].token == WordToken) {
@@ -2472,10 +3805,10 @@ void PLYReader::ParseHeader(Items items) {
         }
 
         else if (item.children[0].value == "face") {
-          facet_count_ = atoi(item.children[1].value.c_str());
+          facet_count_ = ParseInt(item.children[1].value);
 
           for (size_t i = 2; i < item.children.size(); i++) {
-            auto property = item.children[i];
+            const auto &property = item.children[i];
 
             if (property.children.size() > 1) {
               if (property.children[1].token == WordToken) {
@@ -2513,12 +3846,12 @@ void PLYReader::ParseHeader(Items items) {
   }
 }
 
-std::shared_ptr<Mesh> PLYReader::ParseMesh(Items vertex_items,
-                                           Items face_items) {
+std::shared_ptr<Mesh> PLYReader::ParseMesh(const Items &vertex_items,
+                                           const Items &face_items) {
   Points vertices;
   Triangles facets;
 
-  for (auto item : vertex_items) {
+  for (const auto &item : vertex_items) {
     if (item.children.size() == 0) {
       std::stringstream error;
       error << "The vertex appears to be empty."
@@ -2532,7 +3865,7 @@ std::shared_ptr<Mesh> PLYReader::ParseMesh(Items vertex_items,
     }
   }
 
-  for (auto item : face_items) {
+  for (const auto &item : face_items) {
     if (item.children.size() == 0) {
       std::stringstream error;
       error << "The facet appears to be empty."
@@ -2549,11 +3882,11 @@ std::shared_ptr<Mesh> PLYReader::ParseMesh(Items vertex_items,
   return Mesh::New(facets);
 }
 
-G4ThreeVector PLYReader::ParseVertex(Items items) {
+G4ThreeVector PLYReader::ParseVertex(const Items &items) {
   std::vector<double> numbers;
 
-  for (auto item : items) {
-    numbers.push_back((double)atof(item.value.c_str()));
+  for (const auto &item : items) {
+    numbers.push_back(ParseDouble(item.value));
   }
 
   if (numbers.size() < 3) {
@@ -2570,11 +3903,12 @@ G4ThreeVector PLYReader::ParseVertex(Items items) {
   return G4ThreeVector(numbers[x_index_], numbers[y_index_], numbers[z_index_]);
 }
 
-G4TriangularFacet *PLYReader::ParseFacet(Items items, Points vertices) {
+G4TriangularFacet *PLYReader::ParseFacet(const Items &items,
+                                         const Points &vertices) {
   std::vector<int> indices;
 
-  for (auto item : items) {
-    indices.push_back((int)atoi(item.value.c_str()));
+  for (const auto &item : items) {
+    indices.push_back(ParseInt(item.value));
   }
 
   if (indices.size() < 4) {
@@ -2662,20 +3996,20 @@ namespace CADMesh {
 namespace File {
 
 G4bool BuiltInReader::Read(G4String filepath) {
-  File::Reader *reader = nullptr;
+  std::unique_ptr<File::Reader> reader;
 
   auto type = TypeFromName(filepath);
 
   if (type == STL) {
-    reader = new File::STLReader();
+    reader.reset(new File::STLReader());
   }
 
   else if (type == OBJ) {
-    reader = new File::OBJReader();
+    reader.reset(new File::OBJReader());
   }
 
   else if (type == PLY) {
-    reader = new File::PLYReader();
+    reader.reset(new File::PLYReader());
   }
 
   else {
@@ -0,0 +1,55 @@
+/// \file SYPAirShortcut.hh
+/// \brief Definition of the SYPAirShortcut class
+
+#ifndef SYPAirShortcut_h
+#define SYPAirShortcut_h 1
+
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class G4GenericMessenger;
+class G4Material;
+class SYPDetectorConstruction;
+
+/// Analytic transport of the source photons through the air gap.
+///
+/// With /SYP/source/airShortcut true the photon is moved along its
+/// direction from the source to the plane airShortcutGap in front of
+/// the outer window, and its weight is the probability exp(-mu*L) to
+/// cross the air of the world without interaction. The photons
+/// scattered in the air towards the detector are neglected: nothing but
+/// air may lie between the source and the plane.
+///
+/// mu(E) is tabulated in log(E) from G4EmCalculator when the first
+/// photon is transported, the physics tables being built by then.
+
+class SYPAirShortcut
+{
+  public:
+    SYPAirShortcut();
+    ~SYPAirShortcut();
+
+    G4bool IsActive() const { return fActive; }
+
+    // move the photon to the plane, return its weight
+    G4double Transport(G4ThreeVector& position, const G4ThreeVector& direction,
+                       G4double energy);
+
+  private:
+    void BuildTable(const G4Material* material);
+    G4double GetAttenuation(G4double energy) const;
+
+    G4GenericMessenger* fMessenger;
+    G4bool   fActive;
+    G4double fPlaneGap;
+
+    const SYPDetectorConstruction* fDetector;
+    const G4Material* fMaterial;    // material of the tabulated mu
+    std::vector<G4double> fLogMu;   // log(mu) at kTableSize+1 energies
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
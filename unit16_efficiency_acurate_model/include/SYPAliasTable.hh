@@ -0,0 +1,45 @@
+
+/// \file SYPAliasTable.hh
+/// \brief Definition of the SYPAliasTable class
+
+#ifndef SYPAliasTable_h
+#define SYPAliasTable_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+/// Walker alias table of a discrete distribution.
+///
+/// Built once in O(n) (Vose) from non-negative weights, it samples an
+/// index in constant time from one uniform random number, whatever the
+/// number of entries.
+
+class SYPAliasTable
+{
+  public:
+    SYPAliasTable();
+    ~SYPAliasTable();
+
+    // false if there is no positive weight
+    G4bool Build(const std::vector<G4double>& weights);
+
+    G4int GetSize() const { return fProbability.size(); }
+
+    // index sampled from u in [0,1)
+    G4int Sample(G4double u) const
+    {
+      G4double x = u*fProbability.size();
+      G4int i = G4int(x);
+      if (i >= (G4int)fProbability.size()) i = fProbability.size()-1;
+      return (x - i < fProbability[i]) ? i : fAlias[i];
+    }
+
+  private:
+    std::vector<G4double> fProbability;
+    std::vector<G4int>    fAlias;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
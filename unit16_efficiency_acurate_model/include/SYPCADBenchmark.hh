@@ -0,0 +1,53 @@
+/// \file SYPCADBenchmark.hh
+/// \brief Definition of the SYPCADBenchmark class
+
+#ifndef SYPCADBenchmark_h
+#define SYPCADBenchmark_h 1
+
+#include "globals.hh"
+
+/// Timing of the CADMesh readers on a mesh file.
+///
+/// The file is read a number of times with the built-in reader of
+/// CADMesh, without run manager or geometry; the best time gives the
+/// parsing throughput in MB/s of file, printed with the number of
+/// meshes and facets read, and the time to weld the vertices of each
+/// mesh and check its edges. The facets read are then written as ASCII
+/// and binary STL and PLY files, timed the same way, to compare the
+/// ASCII parsers with the binary readers on the same mesh. Last, the
+/// solid of the file is built without cache, with an empty cache and
+/// from the cache written in the working directory.
+/// Built with TetGen (WITH_CADMESH_TETGEN), the tetrahedra of the file
+/// are placed as an assembly of one volume each and as one parameterised
+/// volume, comparing the construction time, the resident memory and the
+/// time of navigation steps from random points.
+/// This is the only translation unit including CADMesh.hh, whose
+/// functions are not inline.
+
+class SYPCADBenchmark
+{
+  public:
+    SYPCADBenchmark();
+    ~SYPCADBenchmark();
+
+    void SetNofRepeats(G4int nofRepeats) { fNofRepeats = nofRepeats; }
+
+    // read and time the file, returns false if it cannot be read
+    G4bool Run(const G4String& fileName);
+
+  private:
+    // best time of the repeats [s], or a negative time if not readable
+    G4double Time(const G4String& fileName, std::size_t& nofFacets) const;
+    void Print(const G4String& label, const G4String& fileName,
+               G4double time, std::size_t nofFacets) const;
+    void TimeCache(const G4String& fileName) const;
+#ifdef USE_CADMESH_TETGEN
+    void TimeTetrahedra(const G4String& fileName) const;
+#endif
+
+    G4int fNofRepeats;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,46 @@
+
+/// \file SYPChamberParameterisation.hh
+/// \brief Definition of the SYPChamberParameterisation class
+
+#ifndef SYPChamberParameterisation_h
+#define SYPChamberParameterisation_h 1
+
+#include "G4VPVParameterisation.hh"
+#include "G4RotationMatrix.hh"
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <vector>
+
+struct SYPGeometryParameters;
+class G4VPhysicalVolume;
+
+/// Parameterisation of the fan of chambers.
+///
+/// Copy number k is the chamberAndWindow of copy number k of the
+/// geometry parameters. The rotation and translation of each copy are
+/// computed once from the images of the three reference points, as
+/// for the placements; the solid is the same for all copies.
+
+class SYPChamberParameterisation : public G4VPVParameterisation
+{
+  public:
+    SYPChamberParameterisation(const SYPGeometryParameters& parameters);
+    virtual ~SYPChamberParameterisation();
+
+    // the copy numbers must be 0 to N-1, each used once
+    static G4bool IsApplicable(const SYPGeometryParameters& parameters);
+
+    G4int GetNofChambers() const { return fTranslations.size(); }
+
+    virtual void ComputeTransformation(const G4int copyNo,
+                                       G4VPhysicalVolume* physVol) const;
+
+  private:
+    std::vector<G4RotationMatrix*> fRotations;
+    std::vector<G4ThreeVector>     fTranslations;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,76 @@
+
+/// \file SYPConvergence.hh
+/// \brief Definition of the SYPConvergence class
+
+#ifndef SYPConvergence_h
+#define SYPConvergence_h 1
+
+#include "SYPRun.hh"
+#include "G4Timer.hh"
+#include "globals.hh"
+
+class G4GenericMessenger;
+
+/// Runs in batches until the efficiencies are precise enough.
+///
+/// /SYP/run/beamOnUntilConverged batchSize does one run of batchSize
+/// events after the other. The tallies of the runs are summed and each
+/// run is also taken as one batch: the error of a unit is the larger of
+/// the error of the summed tallies and the batch-means error (spread of
+/// the batch efficiencies). The series stops when the relative error of
+/// every unit with at least /SYP/run/minCounts counts is below
+/// /SYP/run/targetError, or when /SYP/run/timeBudget or /SYP/run/maxEvents
+/// is reached. The counts of a unit are taken as the effective number
+/// (sum c)^2/(sum c^2) of the event counts c, so that weighted counts
+/// are compared with the same threshold. A series needs a budget: the
+/// event cap is set by default, and can only be removed with a time
+/// budget.
+/// Each batch is stored in the results file as a run of its own.
+/// When the photons are replayed from a phase-space file, each batch
+/// skips the records of the previous ones (/SYP/phaseSpace/skipRecords),
+/// so that the batches are independent; the next runs go on after the
+/// last batch. The series stops at the first batch cut short, e.g.
+/// when all the records are used.
+/// Master only.
+
+class SYPConvergence
+{
+  public:
+    SYPConvergence();
+    ~SYPConvergence();
+
+    void BeamOnUntilConverged(G4int batchSize);
+
+    // called by the master run action at the end of each run
+    G4bool IsActive() const { return fActive; }
+    void AddBatch(const SYPRun* run, G4int nofUnits);
+
+  private:
+    G4double GetBatchError(G4int unit) const;
+    G4double GetError(G4int unit) const;
+    G4double GetNofEffectiveCounts(G4int unit) const;
+    // largest relative error over the units with enough counts,
+    // and its unit
+    G4double GetWorstRelativeError(G4int& worstUnit) const;
+    void PrintSummary(const G4String& reason) const;
+
+    G4GenericMessenger* fMessenger;
+    G4double fTargetError;   // relative
+    G4double fTimeBudget;
+    G4int    fMaxEvents;
+    G4double fMinCounts;
+
+    G4bool   fActive;
+    G4int    fNofUnits;
+    G4int    fNofBatches;
+    G4double fNofEvents;
+    SYPTally fTally;
+    G4int    fNofUnitBatches[SYPTally::kMaxNofUnits];
+    G4double fBatchSum[SYPTally::kMaxNofUnits];
+    G4double fBatchSum2[SYPTally::kMaxNofUnits];
+    G4Timer  fTimer;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
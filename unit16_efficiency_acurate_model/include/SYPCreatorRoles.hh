@@ -0,0 +1,39 @@
+/// \file SYPCreatorRoles.hh
+/// \brief Definition of the SYPCreatorRoles class
+
+#ifndef SYPCreatorRoles_h
+#define SYPCreatorRoles_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+class G4Track;
+
+/// Creator model of a track, as used by the stacking and stepping
+/// actions. The model name is only compared the first time a model
+/// index is met, the role is then cached per index.
+
+enum SYPCreatorRole
+{
+  kCreatorUnknown = -1,
+  kCreatorOther = 0,
+  kCreatorEIoni,
+  kCreatorEBrem
+};
+
+class SYPCreatorRoles
+{
+  public:
+    SYPCreatorRoles();
+    ~SYPCreatorRoles();
+
+    SYPCreatorRole Get(const G4Track* track);
+
+  private:
+    std::vector<SYPCreatorRole> fRoles;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -6,12 +6,50 @@
 #define SYPDetectorConstruction_h 1
 
 #include "G4VUserDetectorConstruction.hh"
+#include "SYPGeometryParameters.hh"
+#include "SYPRun.hh"
 #include "globals.hh"
 
+#include <unordered_map>
+#include <vector>
+
 class G4VPhysicalVolume;
 class G4LogicalVolume;
+class G4VSolid;
+class SYPDetectorMessenger;
+class SYPChamberParameterisation;
+class SYPRetiredSolids;
+
+/// Role of a logical volume in the efficiency scoring.
+/// Resolved once per geometry from the volume names, so that the
+/// stepping action only compares pointers and enums.
+
+enum SYPVolumeRole
+{
+  kOtherVolume = 0,
+  kChamberAndWindowVolume,  // "chamberAndWindow"
+  kChamberVolume,           // "chamber" (one half of a chamber)
+  kMetalVolume              // "EC", "ES", "rib", "shell"
+};
 
 /// Detector construction class to define materials and geometry.
+///
+/// The volumes are built in loops from a SYPGeometryParameters block,
+/// the 16-unit detector by default. The block can be replaced from a
+/// parameter file or by a generated regular array (/SYP/geometry/
+/// commands); the geometry is then rebuilt at the next run.
+/// The rib thickness, slice pitch and window thickness of the design
+/// scans only replace the solids of the ribs, slices or outer window
+/// and leave the rest of the geometry in place. The replaced solids are
+/// deleted once the next run with events has ended, the workers taking
+/// the new ones from the master when that run starts.
+/// Optionally the chambers are one G4PVParameterised instead of one
+/// placement per chamber (see SYPChamberParameterisation).
+/// The gas with the chambers is the region "Gas", the shell, windows,
+/// ribs and electrode slices the region "Metal", each with its own
+/// production cuts (/run/setCutForRegion).
+/// In the variance reduction mode, a G4BOptrForceCollision operator is
+/// attached to the chamber halves in ConstructSDandField().
 
 class SYPDetectorConstruction : public G4VUserDetectorConstruction
 {
@@ -20,16 +58,64 @@ class SYPDetectorConstruction : public G4VUserDetectorConstruction
     virtual ~SYPDetectorConstruction();
 
     virtual G4VPhysicalVolume* Construct();
+    virtual void ConstructSDandField();
 
     // method
     G4LogicalVolume* GetScoringVolume() const { return fScoringVolume; }
+    SYPVolumeRole GetVolumeRole(const G4LogicalVolume* volume) const;
+    // SYPPathVolume of a metal volume, -1 for the others
+    G4int GetPathVolume(const G4LogicalVolume* volume) const;
+
+    const SYPGeometryParameters& GetParameters() const { return fParameters; }
+    G4int GetNofUnits() const { return fParameters.GetNofUnits(); }
+
+    void   SetParameters(const SYPGeometryParameters& parameters);
+    G4bool LoadParameters(const G4String& fileName);
+    void   SetRegularArray(G4int nofChambers, G4double pitch);
+
+    // check the overlaps of every placement when it is built
+    void   SetCheckOverlaps(G4bool check) { fCheckOverlaps = check; }
+
+    // force the gamma collisions in the chambers, needs the
+    // G4GenericBiasingPhysics of the gammas in the physics list
+    void   SetForcedCollision(G4bool forced) { fForcedCollision = forced; }
+    G4bool GetForcedCollision() const { return fForcedCollision; }
+
+    // chambers as one parameterised volume, for large arrays
+    void   SetParameterisedChambers(G4bool parameterised);
+    G4bool GetParameterisedChambers() const { return fParameterisedChambers; }
+
+    // design scans, without a full geometry rebuild
+    void   SetRibThickness(G4double thickness);
+    void   SetSlicePitch(G4double pitch);
+    void   SetWindowThickness(G4double thickness);
 
   protected:
     // function member
     void DefineMaterials();
-    // optionally: G4VPhysicalVolume* DefineVolumes();
+    G4VPhysicalVolume* DefineVolumes();
+    void BuildVolumeRoles();
+    void DefineRegions();
+    void RebuildGeometry();
+    void ReplaceSolid(G4VPhysicalVolume* placement, G4VSolid* solid);
+    void GeometryUpdated(const std::vector<G4VPhysicalVolume*>& placements,
+                         G4double realTime);
     // data member
     G4LogicalVolume*  fScoringVolume;
+    SYPGeometryParameters fParameters;
+    G4bool fCheckOverlaps;
+    G4bool fParameterisedChambers;
+    G4bool fForcedCollision;
+    SYPChamberParameterisation* fChamberParameterisation;
+    SYPDetectorMessenger* fMessenger;
+    SYPRetiredSolids* fRetiredSolids;
+    // placements of the volumes changed by the design scans,
+    // in the order of the parameter lists, empty before Construct()
+    std::vector<G4VPhysicalVolume*> fRibPlacements;
+    std::vector<G4VPhysicalVolume*> fSlicePlacements;
+    G4VPhysicalVolume* fWindowOutPlacement;
+    std::unordered_map<const G4LogicalVolume*, SYPVolumeRole> fVolumeRoles;
+    std::unordered_map<const G4LogicalVolume*, G4int> fPathVolumes;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,59 @@
+
+/// \file SYPDetectorMessenger.hh
+/// \brief Definition of the SYPDetectorMessenger class
+
+#ifndef SYPDetectorMessenger_h
+#define SYPDetectorMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class SYPDetectorConstruction;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithAString;
+class G4UIcmdWithoutParameter;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithABool;
+
+/// Messenger of the detector construction.
+///
+/// /SYP/geometry/load file          read a geometry parameter file
+/// /SYP/geometry/save file          write the current parameters
+/// /SYP/geometry/regular n pitch    regular fan of n chambers
+/// /SYP/geometry/reset              back to the 16-unit detector
+/// /SYP/geometry/parameterised b    chambers as a G4PVParameterised
+/// /SYP/geometry/checkOverlaps b    check the placements built or changed
+///
+/// Design scans, only the affected solids are replaced:
+/// /SYP/geometry/ribThickness t
+/// /SYP/geometry/slicePitch p
+/// /SYP/geometry/windowThickness t
+
+class SYPDetectorMessenger : public G4UImessenger
+{
+  public:
+    SYPDetectorMessenger(SYPDetectorConstruction* detector);
+    virtual ~SYPDetectorMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+  private:
+    SYPDetectorConstruction* fDetector;
+
+    G4UIdirectory*           fDirectory;
+    G4UIcmdWithAString*      fLoadCmd;
+    G4UIcmdWithAString*      fSaveCmd;
+    G4UIcommand*             fRegularCmd;
+    G4UIcmdWithoutParameter* fResetCmd;
+    G4UIcmdWithABool*        fParameterisedCmd;
+    G4UIcmdWithABool*        fCheckOverlapsCmd;
+
+    G4UIcmdWithADoubleAndUnit* fRibThicknessCmd;
+    G4UIcmdWithADoubleAndUnit* fSlicePitchCmd;
+    G4UIcmdWithADoubleAndUnit* fWindowThicknessCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -6,12 +6,23 @@
 #define SYPEventAction_h 1
 
 #include "G4UserEventAction.hh"
+#include "SYPRun.hh"
 #include "globals.hh"
 
+#include <algorithm>
+#include <vector>
+
 class SYPRunAction;
 
 /// Event action class
 ///
+/// Collects the per-chamber tallies of one event, filled by the
+/// stepping action, and adds them to the current SYPRun at the end
+/// of the event.
+/// The primary photon is the track 1 and, when the collisions are
+/// forced, the clones that G4BOptrForceCollision makes of it in the
+/// chambers: a clone carries on the interactions of the primary, which
+/// keeps its track ID in analog transport.
 
 class SYPEventAction : public G4UserEventAction
 {
@@ -23,10 +34,55 @@ class SYPEventAction : public G4UserEventAction
     virtual void EndOfEventAction(const G4Event* event);
 
     void AddEdep(G4double edep) { fEdep += edep; }
+    void AddEdep(G4double edep, G4int unit)
+      { fTally.Edep[unit] += edep; fHasTally = true; }
+    void AddCount(G4int unit, G4double weight = 1.)
+      {
+        fTally.count[unit] += weight;
+        if (fLine >= 0) fTally.countLine[fLine][unit] += weight;
+        fHasTally = true;
+      }
+    void AddPhoton(G4int unit, G4double weight = 1.)
+      {
+        fTally.countPhoton[unit] += weight;
+        if (fLine >= 0) fTally.countPhotonLine[fLine][unit] += weight;
+        fHasTally = true;
+      }
+    void AddPath(G4int unit, const G4double* length)
+      {
+        for (G4int j = 0; j < kNofPathVolumes; j++)
+          fTally.pathLength[unit][j] += length[j];
+        fHasTally = true;
+      }
+
+    void AddKilled(SYPKillCounter counter)
+      { fTally.nofKilled[counter]++; fHasTally = true; }
+
+    // Co-60 line of the primary photon of the event, -1 if none
+    void SetLine(G4int line) { fLine = line; }
+    G4int GetLine() const { return fLine; }
+
+    // the track stands for the primary photon of the event
+    G4bool IsPrimaryPhoton(G4int trackID) const
+      {
+        return trackID == 1
+          || std::find(fPrimaryClones.begin(), fPrimaryClones.end(),
+                       trackID) != fPrimaryClones.end();
+      }
+    void AddPrimaryClone(G4int trackID) { fPrimaryClones.push_back(trackID); }
+
+    // true the first time the primary crosses the phase-space plane
+    G4bool CrossPhaseSpacePlane()
+      { G4bool first = !fCrossedPlane; fCrossedPlane = true; return first; }
 
   private:
     SYPRunAction* fRunAction;
     G4double     fEdep;
+    SYPTally     fTally;
+    G4bool       fHasTally;
+    G4int        fLine;
+    G4bool       fCrossedPlane;
+    std::vector<G4int> fPrimaryClones;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
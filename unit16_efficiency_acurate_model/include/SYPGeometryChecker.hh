@@ -0,0 +1,58 @@
+
+/// \file SYPGeometryChecker.hh
+/// \brief Definition of the SYPGeometryChecker class
+
+#ifndef SYPGeometryChecker_h
+#define SYPGeometryChecker_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+class G4VPhysicalVolume;
+
+/// Overlap check of all the placements of a geometry.
+///
+/// The physical volumes are shared among threads, each checking the
+/// next volume not yet taken with G4VPhysicalVolume::CheckOverlaps()
+/// at the given number of surface points. In multi-threaded builds
+/// every thread gets its own copy of the geometry data, as a worker
+/// thread does; sequential builds check in the calling thread.
+/// The result of each volume is written to a JSON report.
+
+class SYPGeometryChecker
+{
+  public:
+    SYPGeometryChecker();
+    ~SYPGeometryChecker();
+
+    void SetResolution(G4int resolution) { fResolution = resolution; }
+    void SetTolerance(G4double tolerance) { fTolerance = tolerance; }
+    void SetNofThreads(G4int nofThreads) { fNofThreads = nofThreads; }
+
+    // check all the volumes, returns the number of overlapping ones
+    G4int Check();
+
+    G4bool WriteReport(const G4String& fileName) const;
+
+  private:
+    struct Result
+    {
+      G4VPhysicalVolume* volume;
+      G4bool overlaps;
+      G4double time;  // [s]
+    };
+
+    void CheckVolumes(G4int threadIndex);
+
+    G4int    fResolution;
+    G4double fTolerance;
+    G4int    fNofThreads;
+    G4double fTime;
+    std::vector<Result> fResults;
+    G4int    fNext;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,120 @@
+
+/// \file SYPGeometryParameters.hh
+/// \brief Definition of the SYPGeometryParameters class
+
+#ifndef SYPGeometryParameters_h
+#define SYPGeometryParameters_h 1
+
+#include "G4TwoVector.hh"
+#include "G4ThreeVector.hh"
+#include "G4Point3D.hh"
+#include "globals.hh"
+
+#include <vector>
+
+/// Electrode slice (EC or ES) placed in one half of a chamber.
+
+struct SYPElectrodeSlice
+{
+  G4String name;                     // "EC" or "ES"
+  G4int    half;                     // 0 left (y > 0), 1 right (y < 0)
+  G4int    copyNo;
+  G4int    index;                    // slice pitches from the middle ES
+  std::vector<G4TwoVector> vertices; // 4 vertices, same at -dz and +dz
+};
+
+/// Placement of one chamberAndWindow in the gas: the images of the
+/// three reference points of the chamber.
+
+struct SYPChamberPlacement
+{
+  G4int     copyNo;
+  G4Point3D to[3];
+};
+
+/// Rib between two chambers, in the gas.
+
+struct SYPRib
+{
+  G4int copyNo;
+  std::vector<G4TwoVector> vertices;
+};
+
+/// Geometry description of the chamber array.
+///
+/// All the numbers used by SYPDetectorConstruction::Construct(). The
+/// default constructor gives the 16-unit detector. Read() overrides
+/// them from a text file of "keyword values" lines (lengths in mm,
+/// see Write() for the complete list of keywords) and
+/// SetRegularArray() generates the chambers and ribs of a regular fan
+/// with another number of chambers or another pitch, and the gas,
+/// shell, windows and hole around them; it returns false if the hole
+/// behind the window would not fit.
+/// Load() caches the files already parsed, so that the geometry can be
+/// rebuilt between runs without reading the file again.
+/// The SetXxx() methods of the design scans change one dimension and
+/// keep the rest; they return false, leaving the block unchanged, if
+/// the new value does not fit. The slices move by their index, set
+/// when they are created, and must stay in their half-chamber, clear
+/// of each other.
+
+struct SYPGeometryParameters
+{
+  SYPGeometryParameters();
+
+  G4bool Read(const G4String& fileName);
+  G4bool Write(const G4String& fileName) const;
+  G4bool SetRegularArray(G4int nofChambers, G4double pitch);
+
+  // design scans
+  G4bool SetRibThickness(G4double thickness);
+  G4bool SetSlicePitch(G4double pitch);
+  G4bool SetWindowThickness(G4double thickness);
+
+  // parsed file, from the cache if the file did not change
+  static const SYPGeometryParameters* Load(const G4String& fileName);
+
+  // number of chamber units (two per chamber)
+  G4int GetNofUnits() const;
+
+  G4double worldSize;
+
+  G4double shellHalfZ;
+  std::vector<G4TwoVector> shellVertices;
+  G4double gasHalfZ;
+  std::vector<G4TwoVector> gasVertices;
+
+  G4double chamberHalfZ;
+  std::vector<G4TwoVector> chamberAndWindowVertices;
+  std::vector<G4TwoVector> chamberVertices;  // split at y = 0 in 2 units
+
+  G4double ESHalfZ;
+  G4double ECHalfZ;
+  G4double slicePitch;              // mean distance between two slices
+  std::vector<SYPElectrodeSlice> slices;
+
+  G4Point3D chamberReference[3];
+  std::vector<SYPChamberPlacement> chambers;
+
+  G4double ribHalfZ;
+  std::vector<SYPRib> ribs;
+
+  G4ThreeVector windowHalfSize;
+  G4ThreeVector windowPosition;     // in the shell
+  G4ThreeVector windowOutHalfSize;
+  G4ThreeVector windowOutPosition;  // in the world
+  G4ThreeVector holeHalfSize;
+  G4ThreeVector holePosition;       // in the shell
+
+  // fan of the regular array: focus on the x axis, centre of the
+  // chambers and extent of the ribs along x
+  G4double fanFocusX;
+  G4double chamberCentreX;
+  G4double ribStartX;
+  G4double ribEndX;
+  G4double ribThickness;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,95 @@
+/// \file SYPPhaseSpace.hh
+/// \brief Definition of the phase-space file records and of the
+///        SYPPhaseSpaceWriter class
+
+#ifndef SYPPhaseSpace_h
+#define SYPPhaseSpace_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+class G4GenericMessenger;
+
+/// One photon crossing the phase-space plane.
+///
+/// Single precision is enough for a photon 1 mm in front of the window;
+/// the record has no padding and is read in place from the mapped file.
+
+struct SYPPhaseSpaceRecord
+{
+  float        position[3];          // on the plane [mm]
+  float        direction[3];         // unit vector
+  float        energy;               // kinetic energy [MeV]
+  float        weight;
+  std::int32_t line;                 // Co-60 line, -1 if none
+};
+
+/// Header of a phase-space file, followed by the records.
+
+struct SYPPhaseSpaceHeader
+{
+  char          magic[8];
+  std::uint32_t version;
+  std::uint32_t recordSize;
+  G4double      planeX;              // position of the plane [mm]
+  std::uint64_t nofRecords;
+  std::uint64_t nofSourceEvents;     // source photons simulated
+
+  void   Init(G4double plane);
+  G4bool IsValid() const;
+};
+
+/// Writer of the primary photons crossing a plane just in front of the
+/// outer window, x = front face of window_out - planeGap. The gap
+/// leaves room for the thicker windows of the variants replayed later.
+///
+/// The file is shared by the threads: the stepping action of each
+/// worker fills a thread-local buffer, which is appended to the file
+/// under a lock when full and at the end of the run. The master opens
+/// the file at the beginning of a run and updates the counts of the
+/// header at its end. The first run after /SYP/phaseSpace/write creates
+/// the file, the next runs append to it.
+///
+/// Commands (master only): /SYP/phaseSpace/write <file> ("none" to
+/// stop writing), /SYP/phaseSpace/planeGap.
+
+class SYPPhaseSpaceWriter
+{
+  public:
+    static SYPPhaseSpaceWriter* Instance();
+    ~SYPPhaseSpaceWriter();
+
+    // master, at the beginning and the end of a run
+    void BeginOfRun(G4double windowFrontX);
+    void EndOfRun(G4int nofEvents);
+
+    G4bool   IsWriting() const { return fWriting; }
+    G4double GetPlaneX() const { return fPlaneX; }
+
+    // any thread, during the run
+    void Write(const SYPPhaseSpaceRecord& record);
+    void Flush();
+
+  private:
+    SYPPhaseSpaceWriter();
+    void SetFileName(const G4String& fileName);
+
+    static SYPPhaseSpaceWriter* fInstance;
+    static G4ThreadLocal std::vector<SYPPhaseSpaceRecord>* fBuffer;
+
+    G4GenericMessenger* fMessenger;
+    G4String    fFileName;
+    G4double    fPlaneGap;
+    G4double    fPlaneX;
+    G4bool      fWriting;
+    G4bool      fAppend;
+    std::FILE*  fFile;
+    SYPPhaseSpaceHeader fHeader;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
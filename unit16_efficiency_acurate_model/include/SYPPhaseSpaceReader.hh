@@ -0,0 +1,61 @@
+/// \file SYPPhaseSpaceReader.hh
+/// \brief Definition of the SYPPhaseSpaceReader class
+
+#ifndef SYPPhaseSpaceReader_h
+#define SYPPhaseSpaceReader_h 1
+
+#include "SYPPhaseSpace.hh"
+#include "globals.hh"
+
+#include <cstdint>
+#include <vector>
+
+class G4GenericMessenger;
+
+/// Source of the primary photons read back from a phase-space file
+/// written by SYPPhaseSpaceWriter.
+///
+/// The file is memory-mapped read-only, so the threads share the pages
+/// and a record costs no read call. Event eventID of a run replays the
+/// record firstRecord + eventID: a run is restarted anywhere in the file
+/// with /SYP/phaseSpace/firstRecord and, the event seeds being
+/// independent of the record, the file can be replayed several times
+/// (/SYP/phaseSpace/passes) with different detector histories.
+/// skipRecords moves firstRecord on, e.g. past the records of the last
+/// run, so that the next run replays new photons.
+///
+/// Commands, per thread: /SYP/phaseSpace/read <file> ("none": back to
+/// the source), firstRecord, skipRecords, passes.
+
+class SYPPhaseSpaceReader
+{
+  public:
+    SYPPhaseSpaceReader();
+    ~SYPPhaseSpaceReader();
+
+    G4bool IsOpen() const { return fRecords != 0; }
+    const G4String& GetFileName() const { return fFileName; }
+
+    // record of an event of the run, 0 once all the passes are used
+    const SYPPhaseSpaceRecord* GetRecord(G4int eventID) const;
+
+  private:
+    void Open(const G4String& fileName);
+    void Close();
+    void SkipRecords(G4int nofRecords) { fFirstRecord += nofRecords; }
+
+    G4GenericMessenger* fMessenger;
+    G4String fFileName;      // empty if no file is open
+    G4int fFirstRecord;
+    G4int fNofPasses;
+
+    void*        fMap;       // mapped file
+    std::size_t  fMapSize;
+    std::vector<char> fData; // file contents without mmap
+    const SYPPhaseSpaceRecord* fRecords;
+    std::uint64_t fNofRecords;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -12,16 +12,35 @@
 class G4ParticleGun;
 class G4Event;
 class G4Box;
+class G4GenericMessenger;
+class SYPEventAction;
+class SYPRayCaster;
+class SYPSourceGeometry;
+class SYPSourceSpectrum;
+class SYPPhaseSpaceReader;
+class SYPAirShortcut;
 
 /// The primary generator action class with particle gun.
 ///
-/// The default kinematic is a 3 MeV gamma beam, randomly distributed
-/// in front of the chamber of the (X,Y) chamber size.
+/// The default kinematic is a 1.25 MeV gamma fan beam from a point
+/// source 5874.17 mm in front of the chambers; the position and
+/// direction are sampled by SYPSourceGeometry (/SYP/source/ commands).
+/// With /SYP/source/spectrum co60 or file the energy is sampled by
+/// SYPSourceSpectrum instead of the fixed gun energy.
+/// With /SYP/phaseSpace/read the photons are instead replayed from a
+/// phase-space file in front of the window (SYPPhaseSpaceReader).
+/// With /SYP/source/airShortcut the source photons skip the air gap and
+/// start in front of the window with the air attenuation as weight.
+///
+/// With /SYP/gun/rayCast true the photon is not tracked: its entry
+/// unit and the path lengths on the way and through the unit are
+/// computed geometrically
+/// (see SYPRayCaster) and added to the tallies of the event.
 
 class SYPPrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
 {
   public:
-    SYPPrimaryGeneratorAction();
+    SYPPrimaryGeneratorAction(SYPEventAction* eventAction = 0);
     virtual ~SYPPrimaryGeneratorAction();
 
     // method from the base class
@@ -29,9 +48,22 @@ class SYPPrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
   
     // method to access particle gun
     const G4ParticleGun* GetParticleGun() const { return fParticleGun; }
+
+    // energy spectrum of the photons of the next events:
+    // SYPSourceSpectrum::GetDescription() or "phaseSpace <file>"
+    G4String GetSourceDescription() const;
   
   private:
     G4ParticleGun*  fParticleGun; // pointer a to G4 gun class
+
+    SYPEventAction*     fEventAction;
+    G4GenericMessenger* fMessenger;
+    G4bool              fRayCast;
+    SYPRayCaster*       fRayCaster;
+    SYPSourceGeometry*  fSource;
+    SYPSourceSpectrum*  fSpectrum;
+    SYPPhaseSpaceReader* fPhaseSpace;
+    SYPAirShortcut*     fAirShortcut;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
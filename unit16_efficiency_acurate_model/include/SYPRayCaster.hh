@@ -0,0 +1,59 @@
+
+/// \file SYPRayCaster.hh
+/// \brief Definition of the SYPRayCaster class
+
+#ifndef SYPRayCaster_h
+#define SYPRayCaster_h 1
+
+#include "SYPRun.hh"
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+class SYPDetectorConstruction;
+class G4Navigator;
+class G4TouchableHistory;
+class G4VPhysicalVolume;
+
+/// Path of a straight ray up to its exit from a chamber unit.
+
+struct SYPRayPath
+{
+  G4int    unit;                         // -1 if no chamber is entered
+  G4double length[kNofPathVolumes];      // in shell, window, rib, EC, ES
+};
+
+/// Geometry-only transport of the primary photon.
+///
+/// The ray is followed with its own navigator, without physics, from
+/// the gun position until it crosses from a chamberAndWindow into a
+/// chamber, the point where a tracked primary is counted in
+/// countPhoton, and then on until it leaves that chamberAndWindow.
+/// The unattenuated path lengths in the metal volumes crossed on the
+/// way and through the electrode slices of the unit are summed by
+/// kind of volume (SYPDetectorConstruction::GetPathVolume()), all for
+/// the unit entered first. One ray caster per thread.
+
+class SYPRayCaster
+{
+  public:
+    SYPRayCaster();
+    ~SYPRayCaster();
+
+    // the volumes are classified again at the start of each run,
+    // the geometry may have been rebuilt
+    void Cast(const G4ThreeVector& position, const G4ThreeVector& direction,
+              G4int runID, SYPRayPath& path);
+
+  private:
+    G4bool IsInChamber(G4int copyNo) const;
+
+    G4Navigator*        fNavigator;
+    G4TouchableHistory* fTouchable;
+    const SYPDetectorConstruction* fDetector;
+    G4VPhysicalVolume*  fWorld;
+    G4int               fRunID;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
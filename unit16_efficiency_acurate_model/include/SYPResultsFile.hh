@@ -0,0 +1,103 @@
+
+/// \file SYPResultsFile.hh
+/// \brief Definition of the SYPResultsFile class
+
+#ifndef SYPResultsFile_h
+#define SYPResultsFile_h 1
+
+#include "SYPRun.hh"
+#include "globals.hh"
+
+#include <cstdint>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+/// One run as stored in the results file.
+///
+/// The record has a fixed size and no padding, so that the file can
+/// be appended with a single write and read back by record index.
+/// endMark is written last and marks the record as complete.
+
+struct SYPRunRecord
+{
+  // the arrays hold the tallies of all the units of a run
+  static const G4int kMaxNofUnits = SYPTally::kMaxNofUnits;
+  static const G4int kTagLength = 32;
+
+  // run metadata
+  std::int64_t masterSeed;
+  G4double     energy;                 // primary energy [MeV], 0 if the
+                                       // source is not mono-energetic
+  G4double     time;                   // end of run, seconds since epoch
+  G4double     realTime;               // run duration [s]
+  std::int32_t runID;
+  std::int32_t nofEvents;
+  std::int32_t jobIndex;
+  std::int32_t nofThreads;
+  std::int32_t nofUnits;               // units filled in the arrays below
+  std::uint32_t source;                // source id, 0 for the mono gun
+  char         tag[kTagLength];        // geometry tag, '\0' padded
+
+  // per-chamber results
+  G4double count[kMaxNofUnits];
+  G4double countPhoton[kMaxNofUnits];
+  G4double Edep[kMaxNofUnits];            // [MeV]
+  G4double efficiency[kMaxNofUnits];
+  G4double efficiencyError[kMaxNofUnits];
+
+  std::uint64_t endMark;
+
+  void SetTag(const G4String& geometryTag);
+  G4String GetTag() const;
+  // id of a source description (SYPRun::GetSource()), a hash
+  void SetSource(const G4String& description);
+};
+
+/// Binary store of the run results.
+///
+/// The file starts with a small header (magic, version, record size)
+/// followed by SYPRunRecord blocks. Append() opens the file, writes one
+/// record and closes it. A record truncated by a job killed while
+/// writing is padded to the record size by the next Append() and, as
+/// it has no end mark, skipped by the readers. Records are read back
+/// in O(1) by index, looked up by geometry tag and energy (the source
+/// id of the records tells the spectra at energy 0 apart), or exported
+/// to CSV. The lookup uses an index sorted by tag and energy, kept by
+/// the object and extended with the records appended since the last
+/// lookup, so that only new records are read.
+
+class SYPResultsFile
+{
+  public:
+    SYPResultsFile(const G4String& fileName);
+    ~SYPResultsFile();
+
+    G4bool Append(const SYPRunRecord& record) const;
+
+    G4int  GetNofRecords() const;
+    G4bool ReadRecord(G4int index, SYPRunRecord& record) const;
+
+    // indices of the records with the given tag and energy
+    std::vector<G4int> Find(const G4String& tag, G4double energy,
+                            G4double tolerance = 1.e-9) const;
+
+    G4bool ExportCSV(const G4String& csvFileName) const;
+
+    const G4String& GetFileName() const { return fFileName; }
+
+  private:
+    G4bool CheckHeader(std::FILE* file) const;
+    void UpdateIndex() const;
+
+    // (tag, energy) -> record index, sorted
+    typedef std::pair<std::pair<G4String, G4double>, G4int> IndexEntry;
+
+    G4String fFileName;
+    mutable std::vector<IndexEntry> fIndex;
+    mutable G4int fNofIndexed;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,122 @@
+
+/// \file SYPRun.hh
+/// \brief Definition of the SYPRun class
+
+#ifndef SYPRun_h
+#define SYPRun_h 1
+
+#include "G4Run.hh"
+#include "globals.hh"
+
+/// Metal volumes crossed by a photon on its way to a chamber unit
+/// and through it.
+
+enum SYPPathVolume
+{
+  kPathShell = 0,
+  kPathWindow,
+  kPathRib,
+  kPathEC,
+  kPathES,
+  kNofPathVolumes
+};
+
+/// Tracks killed to save time, at their creation by the stacking action
+/// or at a step by the stepping action.
+
+enum SYPKillCounter
+{
+  kKilledStackMetalDelta = 0,   // eIoni e- created in the metal
+  kKilledStackChamberElectron,  // e- created in a chamber
+  kKilledStackChamberBrem,      // eBrem gamma created in a chamber
+  kKilledStepMetalDelta,        // eIoni e- entering the metal
+  kKilledStepChamberElectron,   // e- entering a chamber
+  kKilledStepChamberBrem,       // eBrem gamma entering a chamber
+  kNofKillCounters
+};
+
+/// Tally block of the chamber units.
+///
+/// The same block is filled by the stepping action for one event,
+/// summed into the run at the end of each event and merged from the
+/// workers into the master run. A new tally only has to be added here.
+/// The arrays are sized for the largest supported array; the detector
+/// construction refuses geometries with more units.
+
+struct SYPTally
+{
+  static const G4int kMaxNofUnits = 64;
+  static const G4int kNofLines = 2;    // Co-60 lines, see SYPSourceSpectrum
+
+  G4double count[kMaxNofUnits];        // first-generation e- in the gas,
+                                       // summed with their weights
+  G4double countPhoton[kMaxNofUnits];  // primary photons entering a unit,
+                                       // summed with their weights
+  // sums over the events of the products of the event count c and
+  // event countPhoton p (run only): c^2, p^2 and c*p
+  G4double countSquared[kMaxNofUnits];
+  G4double countPhotonSquared[kMaxNofUnits];
+  G4double countCountPhoton[kMaxNofUnits];
+  G4double Edep[kMaxNofUnits];         // energy deposit in a unit
+  // path lengths of the photons entering a unit, up to their exit
+  // from its chamberAndWindow, summed over the photons (filled by
+  // the ray casting mode only)
+  G4double pathLength[kMaxNofUnits][kNofPathVolumes];
+  // count and countPhoton of the photons emitted in a Co-60 line
+  // (filled with a co60 or tabulated source spectrum only)
+  G4double countLine[kNofLines][kMaxNofUnits];
+  G4double countPhotonLine[kNofLines][kMaxNofUnits];
+  // tracks killed, per SYPKillCounter
+  G4double nofKilled[kNofKillCounters];
+
+  void Reset();
+  void Add(const SYPTally& other);
+  // adds the tally of one event and its products
+  void AddEvent(const SYPTally& eventTally);
+
+  // detection efficiency count/countPhoton and its error over
+  // nofEvents events, those without tally included: ratio estimator
+  // of the event sums (binomial for unweighted 0/1 counts)
+  G4double GetEfficiency(G4int unit) const;
+  G4double GetEfficiencyError(G4int unit, G4double nofEvents) const;
+  G4double GetLineEfficiency(G4int line, G4int unit) const;
+};
+
+/// Run class
+///
+/// Owns the tally block of the run. Per-event deltas are added by
+/// SYPEventAction and worker runs are merged on the master.
+
+class SYPRun : public G4Run
+{
+  public:
+    SYPRun();
+    virtual ~SYPRun();
+
+    virtual void Merge(const G4Run*);
+
+    void AddEvent(const SYPTally& eventTally);
+    const SYPTally& GetTally() const { return fTally; }
+
+    G4double GetEfficiency(G4int unit) const
+      { return fTally.GetEfficiency(unit); }
+    G4double GetEfficiencyError(G4int unit) const
+      { return fTally.GetEfficiencyError(unit, GetNumberOfEvent()); }
+
+    // energy of the primary gun, 0 if the source is not mono-energetic,
+    // and source description (SYPPrimaryGeneratorAction), taken from
+    // the workers on the master
+    void SetPrimaryEnergy(G4double energy) { fPrimaryEnergy = energy; }
+    G4double GetPrimaryEnergy() const { return fPrimaryEnergy; }
+    void SetSource(const G4String& source) { fSource = source; }
+    const G4String& GetSource() const { return fSource; }
+
+  private:
+    SYPTally fTally;
+    G4double fPrimaryEnergy;
+    G4String fSource;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
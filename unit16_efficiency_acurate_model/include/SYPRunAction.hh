@@ -7,15 +7,24 @@
 
 #include "G4UserRunAction.hh"
 #include "G4Accumulable.hh"
+#include "G4Timer.hh"
 #include "globals.hh"
 
 class G4Run;
+class G4GenericMessenger;
+class SYPRun;
+class SYPConvergence;
 
 /// Run action class
 ///
-/// In EndOfRunAction(), it calculates the dose in the selected volume 
-/// from the energy deposit accumulated via stepping and event actions.
-/// The computed dose is then printed on the screen.
+/// In EndOfRunAction(), it calculates the detection efficiency of each
+/// chamber unit from the tallies of the (merged) SYPRun.
+/// The efficiencies are printed on the screen and appended, with the
+/// run metadata, to the binary results file (see SYPResultsFile).
+/// The file name and geometry tag are set with /SYP/results/ commands.
+/// On the master it also owns the SYPConvergence of the runs in batches
+/// and times each run, so that the variance reduction modes can be
+/// compared by their figure of merit (see SYPRunComparison).
 
 class SYPRunAction : public G4UserRunAction
 {
@@ -23,19 +32,28 @@ class SYPRunAction : public G4UserRunAction
     SYPRunAction();
     virtual ~SYPRunAction();
 
-    // virtual G4Run* GenerateRun();
+    virtual G4Run* GenerateRun();
     virtual void BeginOfRunAction(const G4Run*);
     virtual void   EndOfRunAction(const G4Run*);
 
-    void AddEdep ( G4double edep , G4int copyNo );
-    G4double count[16] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
-    G4double countPhoton[16] = { 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
-
-    G4double Edep[16] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
+    void ExportCSV(G4String csvFileName);
 
   private:
+    void DefineCommands();
+    G4int GetNofUnits() const;
+    void PrintPathLengths(const SYPRun* run, G4int nofUnits) const;
+    void PrintLineEfficiencies(const SYPRun* run, G4int nofUnits) const;
+    void PrintKilledTracks(const SYPRun* run) const;
+    void WriteResults(const SYPRun* run, G4int nofUnits) const;
+
     G4Accumulable<G4double> fEdep;
 
+    G4GenericMessenger* fMessenger;
+    SYPConvergence* fConvergence;
+    G4String fResultsFileName;
+    G4String fGeometryTag;
+    G4Timer  fTimer;
+
 };
 
 #endif
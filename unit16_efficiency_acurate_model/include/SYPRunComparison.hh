@@ -0,0 +1,42 @@
+/// \file SYPRunComparison.hh
+/// \brief Definition of the SYPRunComparison class
+
+#ifndef SYPRunComparison_h
+#define SYPRunComparison_h 1
+
+#include "globals.hh"
+
+class SYPResultsFile;
+
+/// Comparison of two runs of a results file, e.g. an analog run and a
+/// run with the collisions forced in the chambers.
+///
+/// The last run stored with the tested tag is compared with the last
+/// run of the reference tag at the same energy and source (a spectrum
+/// or phase-space file is stored as a source id, at energy 0). For
+/// each chamber unit it prints both efficiencies, the pull of their
+/// difference and the gain in figure of merit,
+/// FOM = 1/(relative error^2 * run time), of the tested run over the
+/// reference run.
+
+class SYPRunComparison
+{
+  public:
+    SYPRunComparison(const G4String& fileName);
+    ~SYPRunComparison();
+
+    // largest pull accepted for the two runs to agree
+    void SetMaxPull(G4double maxPull) { fMaxPull = maxPull; }
+
+    // returns the number of units whose pull exceeds the maximum,
+    // or -1 if the runs are not found
+    G4int Compare(const G4String& referenceTag, const G4String& tag) const;
+
+  private:
+    SYPResultsFile* fResultsFile;
+    G4double fMaxPull;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,78 @@
+
+/// \file SYPSeeding.hh
+/// \brief Definition of the SYPSeeding class
+
+#ifndef SYPSeeding_h
+#define SYPSeeding_h 1
+
+#include "globals.hh"
+
+class G4GenericMessenger;
+namespace CLHEP { class HepRandomEngine; }
+
+/// Seeding of the random engines from a master seed and a job index.
+///
+/// The engine is MixMax, whose seeding by up to four 32-bit numbers
+/// selects a stream guaranteed not to overlap with any other choice of
+/// the four numbers. The master engine uses (masterSeed, jobIndex, 0, 0)
+/// and, unless disabled, every event is re-seeded at generation time
+/// with (masterSeed, jobIndex, runID+1, eventID). An event is then
+/// reproducible on its own, independently of the number of threads and
+/// of the order in which the workers process the events.
+/// The photons generated ahead of time by SYPSourceGeometry come from
+/// streams of their own, one per batch of events, seeded with the top
+/// bit of the third number set.
+///
+/// Commands (master only):
+///   /SYP/random/masterSeed, /SYP/random/jobIndex  re-seed the master
+///   /SYP/random/seedEachEvent true|false
+///   /SYP/random/replayRun, /SYP/random/replayEvent  seed the events of
+///     the next runs as the events replayEvent, replayEvent+1, ... of
+///     run replayRun (negative to switch off)
+
+class SYPSeeding
+{
+  public:
+    static SYPSeeding* Instance();
+    ~SYPSeeding();
+
+    // select the engine and seed it, to be called before the run manager
+    void SetSeeds(G4long masterSeed, G4int jobIndex);
+
+    // re-seed the engine of the calling thread for the given event
+    void SeedEvent(G4int runID, G4int eventID) const;
+
+    // run and event whose stream SeedEvent() uses for the given event
+    void GetEventStream(G4int& runID, G4int& eventID) const;
+
+    // seed an engine for a batch of events of a run, as given by
+    // GetEventStream()
+    void SeedBatch(CLHEP::HepRandomEngine* engine, G4int runID,
+                   G4int batchIndex) const;
+
+    G4long GetMasterSeed() const { return fMasterSeed; }
+    G4int  GetJobIndex() const { return fJobIndex; }
+
+    // true if SeedEvent() re-seeds the engine
+    G4bool IsSeedingEachEvent() const
+      { return fSeedEachEvent || (fReplayRunID >= 0 && fReplayEventID >= 0); }
+
+  private:
+    SYPSeeding();
+    void DefineCommands();
+    void SetMasterSeed(G4int masterSeed) { SetSeeds(masterSeed, fJobIndex); }
+    void SetJobIndex(G4int jobIndex) { SetSeeds(fMasterSeed, jobIndex); }
+
+    static SYPSeeding* fInstance;
+
+    G4GenericMessenger* fMessenger;
+    G4long fMasterSeed;
+    G4int  fJobIndex;
+    G4bool fSeedEachEvent;
+    G4int  fReplayRunID;
+    G4int  fReplayEventID;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
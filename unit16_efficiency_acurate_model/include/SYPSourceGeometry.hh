@@ -0,0 +1,82 @@
+
+/// \file SYPSourceGeometry.hh
+/// \brief Definition of the SYPSourceGeometry class
+
+#ifndef SYPSourceGeometry_h
+#define SYPSourceGeometry_h 1
+
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class G4GenericMessenger;
+namespace CLHEP { class HepRandomEngine; }
+
+/// Geometry of the photon source.
+///
+/// The source is a disk of radius spotRadius (0: a point) in the plane
+/// x = -distance, emitting towards +x in a fan whose angles in y and z
+/// are uniform within +-halfAngleY and +-halfAngleZ. The direction is
+/// (1, tan(angleY), tan(angleZ)), normalised; the tangents are
+/// interpolated in tables computed once per parameter change.
+///
+/// The photons are generated in batches of batchSize. When the events
+/// are seeded one by one (SYPSeeding), the batch of the events
+/// k*batchSize, ... of a run is drawn from its own stream, so that the
+/// photon of an event still depends on the event only; a worker then
+/// refills the batch whenever its next event is in another one, and
+/// the batches pay off with /run/eventModulo a multiple of batchSize.
+///
+/// Commands, per thread: /SYP/source/distance, halfAngleY, halfAngleZ,
+/// spotRadius, batchSize.
+
+class SYPSourceGeometry
+{
+  public:
+    SYPSourceGeometry();
+    ~SYPSourceGeometry();
+
+    void SetDistance(G4double distance);
+    void SetHalfAngleY(G4double halfAngle);
+    void SetHalfAngleZ(G4double halfAngle);
+    void SetSpotRadius(G4double radius);
+    void SetBatchSize(G4int batchSize);
+
+    G4double GetDistance() const { return fDistance; }
+
+    // position and unit direction of the photon of the given event
+    void Generate(G4ThreeVector& position, G4ThreeVector& direction,
+                  G4int runID, G4int eventID);
+
+  private:
+    void BuildTables();
+    void FillBatch(G4int size, CLHEP::HepRandomEngine* engine);
+    G4double Interpolate(const std::vector<G4double>& table, G4double u) const;
+
+    G4GenericMessenger* fMessenger;
+
+    G4double fDistance;
+    G4double fHalfAngleY;
+    G4double fHalfAngleZ;
+    G4double fSpotRadius;
+    G4int    fBatchSize;
+
+    G4bool   fTablesValid;
+    std::vector<G4double> fTanY;  // tan at kTableSize+1 angles
+    std::vector<G4double> fTanZ;
+
+    std::vector<G4ThreeVector> fPositions;
+    std::vector<G4ThreeVector> fDirections;
+    std::vector<G4double> fRandoms;  // random numbers of the batch
+    std::size_t fNext;
+
+    // batch drawn from its own stream when the events are seeded
+    CLHEP::HepRandomEngine* fBatchEngine;
+    G4int    fBatchRunID;
+    G4int    fBatchIndex;  // -1 if none
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,66 @@
+
+/// \file SYPSourceSpectrum.hh
+/// \brief Definition of the SYPSourceSpectrum class
+
+#ifndef SYPSourceSpectrum_h
+#define SYPSourceSpectrum_h 1
+
+#include "SYPAliasTable.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class G4GenericMessenger;
+
+/// Energy spectrum of the photon source.
+///
+///  - "mono": the energy of the gun (/gun/energy), as before;
+///  - "co60": the 1.173 and 1.333 MeV lines of Co-60 with their
+///    emission probabilities;
+///  - "file": a table read from /SYP/source/spectrumFile with one
+///    "Elow Ehigh weight" line per bin (MeV); a bin with Elow = Ehigh
+///    is a line, e.g. the two Co-60 lines with the scatter continuum
+///    of the collimator below them.
+///
+/// The bin is sampled from an alias table, so the cost per photon does
+/// not depend on the number of bins. Sample() also returns the Co-60
+/// line (0: 1.173 MeV, 1: 1.333 MeV, -1: other) for the tallies per
+/// line.
+
+class SYPSourceSpectrum
+{
+  public:
+    static const G4int kNofLines = 2;
+
+    SYPSourceSpectrum();
+    ~SYPSourceSpectrum();
+
+    G4bool IsMono() const { return fMode == "mono"; }
+
+    // "mono", "co60" or "file <spectrum file>"
+    G4String GetDescription() const;
+
+    // energy of the next photon, not for the "mono" mode
+    G4double Sample(G4int& line);
+
+    void SetMode(const G4String& mode);
+    void SetFileName(const G4String& fileName);
+
+  private:
+    G4bool Build();
+    G4bool ReadFile(const G4String& fileName);
+
+    G4GenericMessenger* fMessenger;
+    G4String fMode;
+    G4String fFileName;
+    G4bool   fValid;
+
+    std::vector<G4double> fLow;
+    std::vector<G4double> fHigh;
+    std::vector<G4int>    fLine;
+    SYPAliasTable         fTable;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,48 @@
+/// \file SYPStackingAction.hh
+/// \brief Definition of the SYPStackingAction class
+
+#ifndef SYPStackingAction_h
+#define SYPStackingAction_h 1
+
+#include "G4UserStackingAction.hh"
+#include "SYPCreatorRoles.hh"
+#include "globals.hh"
+
+class SYPEventAction;
+class SYPDetectorConstruction;
+class G4ParticleDefinition;
+
+/// Stacking action class
+///
+/// Classifies the secondaries when they are created, from their
+/// particle, creator model and origin volume, so that the uninteresting
+/// ones never take a step:
+///  - eIoni e- created in the metal are killed;
+///  - e- created in a chamber are counted, unless created by eIoni,
+///    and killed;
+///  - eBrem gammas created in a chamber are killed;
+///  - the clones of the primary photon made by the forced collisions
+///    in a chamber are registered as the primary with the event action.
+/// Everything else is urgent. The kills are counted per
+/// SYPKillCounter in the tally of the event.
+
+class SYPStackingAction : public G4UserStackingAction
+{
+  public:
+    SYPStackingAction(SYPEventAction* eventAction);
+    virtual ~SYPStackingAction();
+
+    // method from the base class
+    virtual G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track*);
+
+  private:
+    SYPEventAction* fEventAction;
+    const SYPDetectorConstruction* fDetector;
+    const G4ParticleDefinition* fElectron;
+    const G4ParticleDefinition* fGamma;
+    SYPCreatorRoles fCreatorRoles;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -6,27 +6,44 @@
 #define SYPSteppingAction_h 1
 
 #include "G4UserSteppingAction.hh"
+#include "SYPCreatorRoles.hh"
 #include "globals.hh"
 
 class SYPEventAction;
-class SYPRunAction;
+class SYPDetectorConstruction;
+class SYPPhaseSpaceWriter;
 
 class G4LogicalVolume;
+class G4ParticleDefinition;
 
 /// Stepping action class
 /// 
+/// Volumes, particles and creator models are classified once and
+/// compared by pointer/enum on every step, no string is built here.
+/// The secondaries created in the metal and in the chambers are
+/// killed or counted by SYPStackingAction; the stepping action handles
+/// the tracks entering these volumes from elsewhere.
+/// While a phase-space file is written, the primary photon is recorded
+/// where it first crosses the plane in front of the outer window.
 
 class SYPSteppingAction : public G4UserSteppingAction
 {
   public:
-    SYPSteppingAction(SYPRunAction* fRunAction);
+    SYPSteppingAction(SYPEventAction* eventAction);
     virtual ~SYPSteppingAction();
 
     // method from the base class
     virtual void UserSteppingAction(const G4Step*);
 
   private:
-    SYPRunAction* fRunAction;
+    void WritePhaseSpace(const G4Step* step);
+
+    SYPEventAction* fEventAction;
+    const SYPDetectorConstruction* fDetector;
+    SYPPhaseSpaceWriter* fPhaseSpace;
+    const G4ParticleDefinition* fElectron;
+    const G4ParticleDefinition* fGamma;
+    SYPCreatorRoles fCreatorRoles;
     //G4LogicalVolume* fScoringVolume;
 };
 
@@ -0,0 +1,39 @@
+/// \file SYPTallyCheck.hh
+/// \brief Definition of the SYPTallyCheck class
+
+#ifndef SYPTallyCheck_h
+#define SYPTallyCheck_h 1
+
+#include "globals.hh"
+
+/// Check of the efficiency error of SYPTally with weighted events.
+///
+/// Toy runs are filled through SYPTally::AddEvent() with events whose
+/// photons and counts have non-unit weights, as with the forced
+/// collisions and the air shortcut, and some of which have two photons
+/// entering the same unit, as in ray casting. The error given by the
+/// tally for one run is compared, averaged over the runs, with the
+/// spread of the efficiencies of the runs. No geometry or physics is
+/// needed.
+
+class SYPTallyCheck
+{
+  public:
+    SYPTallyCheck();
+    ~SYPTallyCheck();
+
+    void SetNofRuns(G4int nofRuns) { fNofRuns = nofRuns; }
+    void SetNofEvents(G4int nofEvents) { fNofEvents = nofEvents; }
+
+    // returns false if the mean error and the spread differ by more
+    // than the tolerance (relative)
+    G4bool Check(G4double tolerance = 0.1) const;
+
+  private:
+    G4int fNofRuns;
+    G4int fNofEvents;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -7,6 +7,7 @@
 #include "SYPRunAction.hh"
 #include "SYPEventAction.hh"
 #include "SYPSteppingAction.hh"
+#include "SYPStackingAction.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -31,16 +32,18 @@ void SYPActionInitialization::BuildForMaster() const
 
 void SYPActionInitialization::Build() const
 {
-  SetUserAction(new SYPPrimaryGeneratorAction);
-
   SYPRunAction* runAction = new SYPRunAction;
   SetUserAction(runAction);
   
   SYPEventAction* eventAction = new SYPEventAction(runAction);
   SetUserAction(eventAction);
 
-  SYPSteppingAction* steppingAction = new SYPSteppingAction(runAction);
+  SetUserAction(new SYPPrimaryGeneratorAction(eventAction));
+
+  SYPSteppingAction* steppingAction = new SYPSteppingAction(eventAction);
   SetUserAction(steppingAction);
+
+  SetUserAction(new SYPStackingAction(eventAction));
 }  
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,120 @@
+/// \file SYPAirShortcut.cc
+/// \brief Implementation of the SYPAirShortcut class
+
+#include "SYPAirShortcut.hh"
+#include "SYPDetectorConstruction.hh"
+
+#include "G4EmCalculator.hh"
+#include "G4GenericMessenger.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Material.hh"
+#include "G4Navigator.hh"
+#include "G4RunManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4TransportationManager.hh"
+#include "G4VPhysicalVolume.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+  // log(E) table of the attenuation coefficient
+  const G4int    kTableSize = 256;
+  const G4double kMinEnergy = 1.*keV;
+  const G4double kMaxEnergy = 20.*MeV;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPAirShortcut::SYPAirShortcut()
+: fMessenger(0),
+  fActive(false),
+  fPlaneGap(1.*mm),
+  fDetector(0),
+  fMaterial(0)
+{
+  fMessenger = new G4GenericMessenger(this, "/SYP/source/",
+                                      "Geometry of the photon source");
+
+  G4GenericMessenger::Command& shortcutCmd
+    = fMessenger->DeclareProperty("airShortcut", fActive,
+        "Start the photons in front of the window with the air attenuation"
+        " as weight.");
+  shortcutCmd.SetParameterName("airShortcut", true);
+  shortcutCmd.SetDefaultValue("true");
+
+  G4GenericMessenger::Command& gapCmd
+    = fMessenger->DeclareValueWithUnit("airShortcutGap", "mm", fPlaneGap,
+        "Distance of the start plane in front of the outer window.");
+  gapCmd.SetParameterName("gap", false);
+  gapCmd.SetRange("gap > 0.");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPAirShortcut::~SYPAirShortcut()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPAirShortcut::BuildTable(const G4Material* material)
+{
+  G4EmCalculator calculator;
+  fLogMu.resize(kTableSize+1);
+  G4double logStep = std::log(kMaxEnergy/kMinEnergy)/kTableSize;
+  for (G4int i = 0; i <= kTableSize; i++)
+  {
+    G4double energy = kMinEnergy*std::exp(i*logStep);
+    G4double length
+      = calculator.ComputeGammaAttenuationLength(energy, material);
+    fLogMu[i] = -std::log(length);
+  }
+  fMaterial = material;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double SYPAirShortcut::GetAttenuation(G4double energy) const
+{
+  G4double x = std::log(energy/kMinEnergy)/std::log(kMaxEnergy/kMinEnergy)
+             * kTableSize;
+  x = std::min(std::max(x, 0.), G4double(kTableSize));
+  G4int i = std::min(G4int(x), kTableSize-1);
+  G4double f = x - i;
+  return std::exp(fLogMu[i] + f*(fLogMu[i+1] - fLogMu[i]));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double SYPAirShortcut::Transport(G4ThreeVector& position,
+                                   const G4ThreeVector& direction,
+                                   G4double energy)
+{
+  if (!fDetector)
+  {
+    fDetector = static_cast<const SYPDetectorConstruction*>
+      (G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  }
+
+  // the window may have changed between runs
+  const SYPGeometryParameters& parameters = fDetector->GetParameters();
+  G4double planeX = parameters.windowOutPosition.x()
+                  - parameters.windowOutHalfSize.x() - fPlaneGap;
+  if (direction.x() <= 0. || position.x() >= planeX) return 1.;
+
+  // the world material, rebuilt with the geometry
+  const G4Material* material
+    = G4TransportationManager::GetTransportationManager()
+        ->GetNavigatorForTracking()->GetWorldVolume()
+        ->GetLogicalVolume()->GetMaterial();
+  if (material != fMaterial) BuildTable(material);
+
+  G4double length = (planeX - position.x())/direction.x();
+  position += length*direction;
+  return std::exp(-GetAttenuation(energy)*length);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
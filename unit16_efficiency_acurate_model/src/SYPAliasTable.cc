@@ -0,0 +1,66 @@
+
+/// \file SYPAliasTable.cc
+/// \brief Implementation of the SYPAliasTable class
+
+#include "SYPAliasTable.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPAliasTable::SYPAliasTable()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPAliasTable::~SYPAliasTable()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SYPAliasTable::Build(const std::vector<G4double>& weights)
+{
+  fProbability.clear();
+  fAlias.clear();
+
+  G4int n = weights.size();
+  G4double sum = 0.;
+  for (G4int i = 0; i < n; i++)
+  {
+    if (weights[i] < 0.) return false;
+    sum += weights[i];
+  }
+  if (sum <= 0.) return false;
+
+  // scaled probabilities, split into the entries below and above 1
+  fProbability.resize(n);
+  fAlias.resize(n);
+  std::vector<G4int> small, large;
+  for (G4int i = 0; i < n; i++)
+  {
+    fProbability[i] = weights[i]*n/sum;
+    fAlias[i] = i;
+    if (fProbability[i] < 1.) small.push_back(i);
+    else large.push_back(i);
+  }
+
+  // each small entry is topped up by a large one
+  while (!small.empty() && !large.empty())
+  {
+    G4int s = small.back();
+    small.pop_back();
+    G4int l = large.back();
+    fAlias[s] = l;
+    fProbability[l] -= 1. - fProbability[s];
+    if (fProbability[l] < 1.)
+    {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+
+  // what is left is 1 up to rounding
+  for (G4int i : small) fProbability[i] = 1.;
+  for (G4int i : large) fProbability[i] = 1.;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
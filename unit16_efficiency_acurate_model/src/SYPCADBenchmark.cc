@@ -0,0 +1,389 @@
+/// \file SYPCADBenchmark.cc
+/// \brief Implementation of the SYPCADBenchmark class
+
+#include "SYPCADBenchmark.hh"
+
+#include "G4Timer.hh"
+#include "CADMesh.hh"
+
+#ifdef USE_CADMESH_TETGEN
+#include "G4Box.hh"
+#include "G4GeometryManager.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4Navigator.hh"
+#include "G4NistManager.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4PVPlacement.hh"
+#include "G4RandomDirection.hh"
+#include "G4SolidStore.hh"
+#include "Randomize.hh"
+#endif
+
+#include <cstdint>
+#include <cfloat>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+
+namespace
+{
+  G4double FileSize(const G4String& fileName)  // [MB]
+  {
+    std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+    return file ? G4double(file.tellg())/(1024.*1024.) : 0.;
+  }
+
+#ifdef USE_CADMESH_TETGEN
+  G4double ResidentMemory()  // [MB], 0 where /proc is not available
+  {
+    std::ifstream statm("/proc/self/statm");
+    G4double size = 0., resident = 0.;
+    if ( ! ( statm >> size >> resident ) ) return 0.;
+    return resident*4096./(1024.*1024.);
+  }
+#endif
+
+  template <typename T> void WriteBinary(std::ofstream& file, T value)
+  {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  // the facets of all the meshes as one mesh, in the four encodings;
+  // the binary files are written in the host byte order, little-endian
+  // on the farm machines
+  void WriteSTL(const CADMesh::Meshes& meshes, const G4String& fileName,
+                G4bool binary)
+  {
+    std::ofstream file(fileName, binary ? std::ios::binary : std::ios::out);
+    file.precision(9);
+    std::uint32_t nofFacets = 0;
+    for ( const auto& mesh : meshes ) {
+      nofFacets += mesh->GetTriangles().size();
+    }
+
+    if ( binary ) {
+      file << std::string(80, ' ');
+      WriteBinary(file, nofFacets);
+    }
+    else {
+      file << "solid benchmark\n";
+    }
+    for ( const auto& mesh : meshes ) {
+      for ( const auto triangle : mesh->GetTriangles() ) {
+        if ( binary ) {
+          for ( G4int i = 0; i < 12; i++ ) WriteBinary(file, 0.f);
+          for ( G4int i = 0; i < 3; i++ ) {
+            G4ThreeVector vertex = triangle->GetVertex(i);
+            WriteBinary(file, G4float(vertex.x()));
+            WriteBinary(file, G4float(vertex.y()));
+            WriteBinary(file, G4float(vertex.z()));
+          }
+          WriteBinary(file, std::uint16_t(0));
+          continue;
+        }
+        file << "facet normal 0 0 0\nouter loop\n";
+        for ( G4int i = 0; i < 3; i++ ) {
+          G4ThreeVector vertex = triangle->GetVertex(i);
+          file << "vertex " << vertex.x() << " " << vertex.y() << " "
+               << vertex.z() << "\n";
+        }
+        file << "endloop\nendfacet\n";
+      }
+    }
+    if ( ! binary ) {
+      file << "endsolid benchmark\n";
+    }
+  }
+
+  // three vertices for each facet, not shared
+  void WritePLY(const CADMesh::Meshes& meshes, const G4String& fileName,
+                G4bool binary)
+  {
+    std::ofstream file(fileName, binary ? std::ios::binary : std::ios::out);
+    file.precision(9);
+    std::int32_t nofFacets = 0;
+    for ( const auto& mesh : meshes ) {
+      nofFacets += mesh->GetTriangles().size();
+    }
+
+    file << "ply\nformat "
+         << ( binary ? ( CADMesh::File::IsHostBigEndian()
+                         ? "binary_big_endian" : "binary_little_endian" )
+                     : "ascii" ) << " 1.0\n"
+         << "element vertex " << 3*nofFacets << "\n"
+         << "property float x\nproperty float y\nproperty float z\n"
+         << "element face " << nofFacets << "\n"
+         << "property list uchar int vertex_indices\nend_header\n";
+    for ( const auto& mesh : meshes ) {
+      for ( const auto triangle : mesh->GetTriangles() ) {
+        for ( G4int i = 0; i < 3; i++ ) {
+          G4ThreeVector vertex = triangle->GetVertex(i);
+          if ( binary ) {
+            WriteBinary(file, G4float(vertex.x()));
+            WriteBinary(file, G4float(vertex.y()));
+            WriteBinary(file, G4float(vertex.z()));
+          }
+          else {
+            file << vertex.x() << " " << vertex.y() << " " << vertex.z()
+                 << "\n";
+          }
+        }
+      }
+    }
+    for ( std::int32_t i = 0; i < nofFacets; i++ ) {
+      if ( binary ) {
+        WriteBinary(file, std::uint8_t(3));
+        for ( G4int j = 0; j < 3; j++ ) WriteBinary(file, 3*i + j);
+      }
+      else {
+        file << "3 " << 3*i << " " << 3*i + 1 << " " << 3*i + 2 << "\n";
+      }
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPCADBenchmark::SYPCADBenchmark()
+: fNofRepeats(5)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPCADBenchmark::~SYPCADBenchmark()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SYPCADBenchmark::Run(const G4String& fileName)
+{
+  if ( FileSize(fileName) <= 0. ) {
+    G4cerr << " Cannot open " << fileName << G4endl;
+    return false;
+  }
+
+  std::size_t nofFacets = 0;
+  G4double time = Time(fileName, nofFacets);
+  G4cout << " CAD benchmark, best of " << fNofRepeats << G4endl;
+  Print("input", fileName, time, nofFacets);
+
+  // the same facets in each encoding, written in the working directory
+  auto reader = CADMesh::File::BuiltIn();
+  reader->Read(fileName);
+  CADMesh::Meshes meshes = reader->GetMeshes();
+
+  // welding of the vertices and check of the edges, on copies not indexed
+  for ( const auto& mesh : meshes ) {
+    auto copy = CADMesh::Mesh::New(mesh->GetTriangles(), mesh->GetName());
+    G4Timer timer;
+    timer.Start();
+    G4bool valid = copy->IsValidForNavigation();
+    timer.Stop();
+    G4cout << "   " << std::setw(11) << std::left << "validation"
+           << std::right << std::setw(10) << copy->GetPoints().size()
+           << " pt " << std::setw(9) << mesh->GetTriangles().size()
+           << " facets " << std::setw(10) << timer.GetRealElapsed() << " s "
+           << ( valid ? "closed" : "not closed" ) << G4endl;
+  }
+
+  const G4String encodings[4] = { "ascii.stl", "binary.stl",
+                                  "ascii.ply", "binary.ply" };
+  for ( const auto& encoding : encodings ) {
+    G4String copy = "cadBenchmark." + encoding;
+    G4bool binary = ( encoding.find("binary") != std::string::npos );
+    if ( encoding.find("stl") != std::string::npos ) {
+      WriteSTL(meshes, copy, binary);
+    }
+    else {
+      WritePLY(meshes, copy, binary);
+    }
+    time = Time(copy, nofFacets);
+    Print(encoding, copy, time, nofFacets);
+    std::remove(copy.c_str());
+  }
+
+  TimeCache(fileName);
+#ifdef USE_CADMESH_TETGEN
+  TimeTetrahedra(fileName);
+#endif
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double SYPCADBenchmark::Time(const G4String& fileName,
+                               std::size_t& nofFacets) const
+{
+  // a new reader for each pass, the meshes of a reader accumulate
+  G4double bestTime = -1.;
+  nofFacets = 0;
+  for ( G4int i = 0; i < fNofRepeats; i++ ) {
+    auto reader = CADMesh::File::BuiltIn();
+    G4Timer timer;
+    timer.Start();
+    G4bool read = reader->Read(fileName);
+    timer.Stop();
+    if ( ! read ) return -1.;
+
+    if ( bestTime < 0. || timer.GetRealElapsed() < bestTime ) {
+      bestTime = timer.GetRealElapsed();
+    }
+    nofFacets = 0;
+    for ( const auto& mesh : reader->GetMeshes() ) {
+      nofFacets += mesh->GetTriangles().size();
+    }
+  }
+  return bestTime;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPCADBenchmark::Print(const G4String& label, const G4String& fileName,
+                            G4double time, std::size_t nofFacets) const
+{
+  G4double megaBytes = FileSize(fileName);
+  G4cout << "   " << std::setw(11) << std::left << label << std::right
+         << std::setw(10) << megaBytes << " MB "
+         << std::setw(9) << nofFacets << " facets ";
+  if ( time < 0. ) {
+    G4cout << " not readable" << G4endl;
+    return;
+  }
+  G4cout << std::setw(10) << time << " s "
+         << std::setw(10) << ( time > 0. ? megaBytes/time : 0. ) << " MB/s"
+         << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPCADBenchmark::TimeCache(const G4String& fileName) const
+{
+  // the key of the cache file, to remove it afterwards
+  CADMesh::File::MappedFile file(fileName);
+  CADMesh::File::MeshCache cache(".");
+  G4String cacheFile =
+    cache.FilePath(CADMesh::File::MeshCache::Key(file.Data(),
+                                                 "BuiltInReader", 1.,
+                                                 G4ThreeVector()));
+  std::remove(cacheFile.c_str());
+
+  const G4String labels[3] = { "no cache", "cache miss", "cache hit" };
+  const G4String directories[3] = { "", ".", "." };
+  for ( G4int i = 0; i < 3; i++ ) {
+    // the miss writes the cache, it is timed once
+    G4int nofRepeats = ( i == 1 ) ? 1 : fNofRepeats;
+    G4double bestTime = -1.;
+    std::size_t nofFacets = 0;
+    for ( G4int j = 0; j < nofRepeats; j++ ) {
+      G4Timer timer;
+      timer.Start();
+      auto mesh = std::make_shared<CADMesh::TessellatedMesh>(
+        fileName, CADMesh::File::TypeFromName(fileName));
+      mesh->SetCacheDirectory(directories[i]);
+      G4TessellatedSolid* solid = mesh->GetTessellatedSolid();
+      timer.Stop();
+
+      nofFacets = solid->GetNumberOfFacets();
+      delete solid;
+      if ( bestTime < 0. || timer.GetRealElapsed() < bestTime ) {
+        bestTime = timer.GetRealElapsed();
+      }
+    }
+    G4cout << "   solid, " << std::setw(10) << std::left << labels[i]
+           << std::right << std::setw(9) << nofFacets << " facets "
+           << std::setw(10) << bestTime << " s" << G4endl;
+  }
+  std::remove(cacheFile.c_str());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#ifdef USE_CADMESH_TETGEN
+void SYPCADBenchmark::TimeTetrahedra(const G4String& fileName) const
+{
+  // the stores are cleaned after each world, the benchmark runs before
+  // the detector construction
+  G4NistManager* nist = G4NistManager::Instance();
+  G4Material* material = nist->FindOrBuildMaterial("G4_WATER");
+  G4Material* air = nist->FindOrBuildMaterial("G4_AIR");
+  const G4int nofSteps = 100000;
+
+  // the parameterised volume first, the memory freed by the assembly
+  // would hide its own
+  const G4String labels[2] = { "parameterised", "assembly" };
+  for ( G4int i = 0; i < 2; i++ ) {
+    auto mesh = std::make_shared<CADMesh::TetrahedralMesh>(
+      fileName, CADMesh::File::TypeFromName(fileName));
+    mesh->SetMaterial(material);
+
+    // tetgen is not timed, it is the same for both
+    mesh->Tetrahedralize();
+    auto tets = mesh->GetTetgenOutput();
+    if ( tets->numberoftetrahedra <= 0 ) {
+      G4cout << "   tetrahedra not readable" << G4endl;
+      return;
+    }
+    G4ThreeVector lower(DBL_MAX, DBL_MAX, DBL_MAX);
+    G4ThreeVector upper = -lower;
+    for ( G4int j = 0; j < tets->numberofpoints; j++ ) {
+      for ( G4int k = 0; k < 3; k++ ) {
+        lower[k] = std::min(lower[k], tets->pointlist[3*j + k]);
+        upper[k] = std::max(upper[k], tets->pointlist[3*j + k]);
+      }
+    }
+    G4ThreeVector halfSize = 0.5*(upper - lower) + G4ThreeVector(1., 1., 1.);
+    // the tetrahedra are centered in the world
+    mesh->SetOffset(0.5*(upper + lower));
+
+    G4double memory = ResidentMemory();
+    G4Timer timer;
+    timer.Start();
+    auto worldSolid = new G4Box("cadWorld", halfSize.x(), halfSize.y(),
+                                halfSize.z());
+    auto worldLV = new G4LogicalVolume(worldSolid, air, "cadWorld");
+    if ( i == 0 ) {
+      mesh->GetParameterisedVolume(worldLV);
+    }
+    else {
+      G4ThreeVector position;
+      G4RotationMatrix rotation;
+      mesh->GetAssembly()->MakeImprint(worldLV, position, &rotation);
+    }
+    auto worldPV = new G4PVPlacement(nullptr, G4ThreeVector(), worldLV,
+                                     "cadWorld", nullptr, false, 0);
+    G4GeometryManager::GetInstance()->CloseGeometry(true, false, worldPV);
+    timer.Stop();
+    G4double buildTime = timer.GetRealElapsed();
+    memory = ResidentMemory() - memory;
+
+    G4Navigator navigator;
+    navigator.SetWorldVolume(worldPV);
+    timer.Start();
+    for ( G4int j = 0; j < nofSteps; j++ ) {
+      G4ThreeVector point(
+        (2.*G4UniformRand() - 1.)*halfSize.x(),
+        (2.*G4UniformRand() - 1.)*halfSize.y(),
+        (2.*G4UniformRand() - 1.)*halfSize.z());
+      G4ThreeVector direction = G4RandomDirection();
+      G4double safety = 0.;
+      navigator.LocateGlobalPointAndSetup(point, &direction, false, false);
+      navigator.ComputeStep(point, direction, kInfinity, safety);
+    }
+    timer.Stop();
+
+    G4cout << "   tets, " << std::setw(13) << std::left << labels[i]
+           << std::right << std::setw(9) << tets->numberoftetrahedra
+           << " tets " << std::setw(10) << buildTime << " s "
+           << std::setw(8) << memory << " MB "
+           << std::setw(8) << 1.e6*timer.GetRealElapsed()/nofSteps
+           << " us/step" << G4endl;
+
+    G4GeometryManager::GetInstance()->OpenGeometry(worldPV);
+    G4PhysicalVolumeStore::Clean();
+    G4LogicalVolumeStore::Clean();
+    G4SolidStore::Clean();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+#endif
@@ -0,0 +1,66 @@
+
+/// \file SYPChamberParameterisation.cc
+/// \brief Implementation of the SYPChamberParameterisation class
+
+#include "SYPChamberParameterisation.hh"
+#include "SYPGeometryParameters.hh"
+
+#include "G4VPhysicalVolume.hh"
+#include "G4Transform3D.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPChamberParameterisation::SYPChamberParameterisation
+  (const SYPGeometryParameters& parameters)
+: G4VPVParameterisation()
+{
+  const G4Point3D* from = parameters.chamberReference;
+  G4int nofChambers = parameters.chambers.size();
+  fRotations.resize(nofChambers, 0);
+  fTranslations.resize(nofChambers);
+
+  for (const auto& placement : parameters.chambers)
+  {
+    G4Transform3D transform(from[0], from[1], from[2],
+                            placement.to[0], placement.to[1], placement.to[2]);
+
+    // a placement keeps the inverse rotation (frame rotation)
+    fRotations[placement.copyNo]
+      = new G4RotationMatrix(transform.getRotation().inverse());
+    fTranslations[placement.copyNo] = transform.getTranslation();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPChamberParameterisation::~SYPChamberParameterisation()
+{
+  for (auto rotation : fRotations) delete rotation;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SYPChamberParameterisation::IsApplicable
+  (const SYPGeometryParameters& parameters)
+{
+  G4int nofChambers = parameters.chambers.size();
+  std::vector<G4bool> used(nofChambers, false);
+  for (const auto& placement : parameters.chambers)
+  {
+    if (placement.copyNo < 0 || placement.copyNo >= nofChambers
+        || used[placement.copyNo]) return false;
+    used[placement.copyNo] = true;
+  }
+  return nofChambers > 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPChamberParameterisation::ComputeTransformation
+  (const G4int copyNo, G4VPhysicalVolume* physVol) const
+{
+  physVol->SetTranslation(fTranslations[copyNo]);
+  physVol->SetRotation(fRotations[copyNo]);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,256 @@
+
+/// \file SYPConvergence.cc
+/// \brief Implementation of the SYPConvergence class
+
+#include "SYPConvergence.hh"
+
+#include "G4RunManager.hh"
+#include "G4GenericMessenger.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4UIcommand.hh"
+#include "G4UImanager.hh"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace
+{
+  // batches needed before the batch-means error is trusted
+  const G4int kMinNofBatches = 5;
+
+  // event cap of a series started without another budget
+  const G4int kDefaultMaxEvents = 100000000;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPConvergence::SYPConvergence()
+: fMessenger(0),
+  fTargetError(0.01),
+  fTimeBudget(0.),
+  fMaxEvents(kDefaultMaxEvents),
+  fMinCounts(10.),
+  fActive(false),
+  fNofUnits(0),
+  fNofBatches(0),
+  fNofEvents(0.)
+{
+  fMessenger = new G4GenericMessenger(this, "/SYP/run/",
+                                      "Runs until convergence");
+
+  G4GenericMessenger::Command& targetCmd
+    = fMessenger->DeclareProperty("targetError", fTargetError,
+        "Relative error to reach in every unit hit by photons.");
+  targetCmd.SetParameterName("targetError", false);
+  targetCmd.SetRange("targetError > 0.");
+  targetCmd.command->SetToBeBroadcasted(false);
+
+  G4GenericMessenger::Command& budgetCmd
+    = fMessenger->DeclarePropertyWithUnit("timeBudget", "s", fTimeBudget,
+        "Wall-clock time after which no new batch is started (0: none).");
+  budgetCmd.SetParameterName("timeBudget", false);
+  budgetCmd.command->SetToBeBroadcasted(false);
+
+  G4GenericMessenger::Command& maxEventsCmd
+    = fMessenger->DeclareProperty("maxEvents", fMaxEvents,
+        "Events after which no new batch is started"
+        " (0: none, needs a time budget).");
+  maxEventsCmd.SetParameterName("maxEvents", false);
+  maxEventsCmd.SetRange("maxEvents >= 0");
+  maxEventsCmd.command->SetToBeBroadcasted(false);
+
+  G4GenericMessenger::Command& minCountsCmd
+    = fMessenger->DeclareProperty("minCounts", fMinCounts,
+        "Effective counts below which a unit is left out of the target.");
+  minCountsCmd.SetParameterName("minCounts", false);
+  minCountsCmd.SetRange("minCounts >= 0.");
+  minCountsCmd.command->SetToBeBroadcasted(false);
+
+  G4GenericMessenger::Command& beamOnCmd
+    = fMessenger->DeclareMethod("beamOnUntilConverged",
+        &SYPConvergence::BeamOnUntilConverged,
+        "Do runs of batchSize events until the target error is reached.");
+  beamOnCmd.SetParameterName("batchSize", false);
+  beamOnCmd.SetRange("batchSize > 0");
+  beamOnCmd.command->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPConvergence::~SYPConvergence()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPConvergence::BeamOnUntilConverged(G4int batchSize)
+{
+  if (fTimeBudget <= 0. && fMaxEvents <= 0)
+  {
+    G4ExceptionDescription description;
+    description << "No budget for the series: set /SYP/run/maxEvents"
+                << " or /SYP/run/timeBudget.";
+    G4Exception("SYPConvergence::BeamOnUntilConverged()", "SYPConv001",
+                JustWarning, description);
+    return;
+  }
+
+  fActive = true;
+  fNofUnits = 0;
+  fNofBatches = 0;
+  fNofEvents = 0.;
+  fTally.Reset();
+  for (G4int i = 0; i < SYPTally::kMaxNofUnits; i++)
+  {
+    fNofUnitBatches[i] = 0;
+    fBatchSum[i] = 0.;
+    fBatchSum2[i] = 0.;
+  }
+  fTimer.Start();
+
+  G4RunManager* runManager = G4RunManager::GetRunManager();
+  G4String reason;
+  for (G4int nofRuns = 0; reason.empty(); nofRuns++)
+  {
+    // a phase-space file replays new records in each batch, the command
+    // reaches the readers of the workers at the start of the run
+    if (nofRuns > 0)
+    {
+      G4UImanager::GetUIpointer()->ApplyCommand
+        ("/SYP/phaseSpace/skipRecords "
+         + G4UIcommand::ConvertToString(batchSize));
+    }
+    G4double nofEvents = fNofEvents;
+    runManager->BeamOn(batchSize);
+    fTimer.Stop();
+
+    G4int worstUnit = -1;
+    G4double worstError = GetWorstRelativeError(worstUnit);
+    G4cout << " Batch " << fNofBatches << ": " << fNofEvents << " events, "
+           << fTimer.GetRealElapsed() << " s, largest relative error "
+           << worstError;
+    if (worstUnit >= 0) G4cout << " in Chamber[" << worstUnit << "]";
+    G4cout << G4endl;
+
+    if (fNofBatches == 0) reason = "no event processed";
+    else if (fNofEvents - nofEvents < batchSize)
+      reason = "run aborted";  // e.g. all the phase-space records used
+    else if (fNofBatches >= kMinNofBatches && worstError < fTargetError)
+      reason = "target error reached";
+    else if (fTimeBudget > 0. && fTimer.GetRealElapsed() >= fTimeBudget/s)
+      reason = "time budget used";
+    else if (fMaxEvents > 0 && fNofEvents >= fMaxEvents)
+      reason = "event budget used";
+  }
+
+  fActive = false;
+  PrintSummary(reason);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPConvergence::AddBatch(const SYPRun* run, G4int nofUnits)
+{
+  fNofUnits = nofUnits;
+  fNofBatches++;
+  fNofEvents += run->GetNumberOfEvent();
+  fTally.Add(run->GetTally());
+
+  for (G4int i = 0; i < nofUnits; i++)
+  {
+    if (run->GetTally().countPhoton[i] <= 0.) continue;
+    G4double efficiency = run->GetEfficiency(i);
+    fNofUnitBatches[i]++;
+    fBatchSum[i] += efficiency;
+    fBatchSum2[i] += efficiency*efficiency;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double SYPConvergence::GetBatchError(G4int unit) const
+{
+  G4int n = fNofUnitBatches[unit];
+  if (n < 2) return 0.;
+
+  G4double mean = fBatchSum[unit]/n;
+  G4double variance = (fBatchSum2[unit] - n*mean*mean)/(n-1);
+  return (variance > 0.) ? std::sqrt(variance/n) : 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double SYPConvergence::GetError(G4int unit) const
+{
+  G4double error = fTally.GetEfficiencyError(unit, fNofEvents);
+  if (fNofUnitBatches[unit] >= kMinNofBatches)
+  {
+    error = std::max(error, GetBatchError(unit));
+  }
+  return error;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double SYPConvergence::GetNofEffectiveCounts(G4int unit) const
+{
+  G4double countSquared = fTally.countSquared[unit];
+  return (countSquared > 0.)
+    ? fTally.count[unit]*fTally.count[unit]/countSquared : 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double SYPConvergence::GetWorstRelativeError(G4int& worstUnit) const
+{
+  worstUnit = -1;
+  G4double worstError = 0.;
+  for (G4int i = 0; i < fNofUnits; i++)
+  {
+    // a unit without counts (e.g. out of the beam) has no relative
+    // error and would never converge
+    G4double efficiency = fTally.GetEfficiency(i);
+    if (efficiency <= 0. || GetNofEffectiveCounts(i) < fMinCounts) continue;
+
+    G4double relativeError = GetError(i)/efficiency;
+    if (worstUnit < 0 || relativeError > worstError)
+    {
+      worstUnit = i;
+      worstError = relativeError;
+    }
+  }
+  return (worstUnit < 0) ? DBL_MAX : worstError;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPConvergence::PrintSummary(const G4String& reason) const
+{
+  G4cout
+   << G4endl
+   << "--------------------End of Convergence Series---------------"
+   << G4endl
+   << " " << fNofBatches << " batches, " << fNofEvents << " events, "
+   << fTimer.GetRealElapsed() << " s: " << reason << G4endl;
+
+  for (G4int i = 0; i < fNofUnits; i++)
+  {
+    G4cout << " Detection Efficiency in Chamber[" << i << "] is: "
+           << fTally.GetEfficiency(i)*100 << " +- " << GetError(i)*100
+           << " % (summed " << fTally.GetEfficiencyError(i, fNofEvents)*100
+           << ", batch means " << GetBatchError(i)*100 << ")";
+    if (GetNofEffectiveCounts(i) < fMinCounts)
+    {
+      G4cout << " not converged: " << GetNofEffectiveCounts(i) << " counts";
+    }
+    G4cout << G4endl;
+  }
+  G4cout
+   << "------------------------------------------------------------"
+   << G4endl
+   << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
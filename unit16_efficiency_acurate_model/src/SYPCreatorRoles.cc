@@ -0,0 +1,40 @@
+/// \file SYPCreatorRoles.cc
+/// \brief Implementation of the SYPCreatorRoles class
+
+#include "SYPCreatorRoles.hh"
+
+#include "G4Track.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPCreatorRoles::SYPCreatorRoles()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPCreatorRoles::~SYPCreatorRoles()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPCreatorRole SYPCreatorRoles::Get(const G4Track* track)
+{
+  // the primary has model index -1
+  std::size_t index = track->GetCreatorModelID() + 1;
+  if (index >= fRoles.size())
+  {
+    fRoles.resize(index+1, kCreatorUnknown);
+  }
+
+  // the name is only looked at the first time a model is met
+  if (fRoles[index] == kCreatorUnknown)
+  {
+    const G4String& createProcess = track->GetCreatorModelName();
+    if (createProcess == "eIoni") fRoles[index] = kCreatorEIoni;
+    else if (createProcess == "eBrem") fRoles[index] = kCreatorEBrem;
+    else fRoles[index] = kCreatorOther;
+  }
+  return fRoles[index];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
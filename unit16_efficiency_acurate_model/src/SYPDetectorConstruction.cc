@@ -1,11 +1,16 @@
-
 /// \file B1DetectorConstruction.cc
 /// \brief Implementation of the B1DetectorConstruction class
 
 #include <G4GenericTrap.hh>
 #include "SYPDetectorConstruction.hh"
+#include "SYPDetectorMessenger.hh"
+#include "SYPChamberParameterisation.hh"
+#include "SYPRun.hh"
 
 #include "G4RunManager.hh"
+#include "G4StateManager.hh"
+#include "G4VStateDependent.hh"
+#include "G4Timer.hh"
 #include "G4NistManager.hh"
 #include "G4Box.hh"
 #include "G4Cons.hh"
@@ -13,27 +18,133 @@
 #include "G4Sphere.hh"
 #include "G4Trd.hh"
 #include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
 #include "G4PVPlacement.hh"
+#include "G4PVParameterised.hh"
+#include "G4MultiUnion.hh"
+#include "G4SubtractionSolid.hh"
 #include "G4SystemOfUnits.hh"
-#include "CADMesh.hh"
+#include "G4BOptrForceCollision.hh"
+
+namespace
+{
+  // generic trapezoid with the same 4 vertices at -halfZ and +halfZ
+  G4GenericTrap* MakeTrap(const G4String& name, G4double halfZ,
+                          const std::vector<G4TwoVector>& quad)
+  {
+    std::vector<G4TwoVector> vertices(quad);
+    vertices.insert(vertices.end(), quad.begin(), quad.end());
+    return new G4GenericTrap(name, halfZ, vertices);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+/// Solids replaced by the design scans on the master.
+///
+/// The workers keep their own pointers to the solids of the logical
+/// volumes and copy the master ones only when the next run with events
+/// starts: the replaced solids are deleted when that run has ended,
+/// seen as the state going from GeomClosed back to Idle.
+
+class SYPRetiredSolids : public G4VStateDependent
+{
+  public:
+    SYPRetiredSolids() : G4VStateDependent() {}
+    virtual ~SYPRetiredSolids() {}
+
+    void Retire(G4VSolid* solid) { fSolids.push_back(solid); }
+
+    // the solids were deleted with the solid store
+    void Forget() { fSolids.clear(); }
+
+    virtual G4bool Notify(G4ApplicationState requestedState)
+    {
+      G4StateManager* stateManager = G4StateManager::GetStateManager();
+      G4RunManager* runManager = G4RunManager::GetRunManager();
+      if (requestedState == G4State_Idle
+          && stateManager->GetCurrentState() == G4State_GeomClosed
+          && runManager->GetNumberOfEventsToBeProcessed() > 0)
+      {
+        for (auto solid : fSolids) delete solid;
+        fSolids.clear();
+      }
+      return true;
+    }
+
+  private:
+    std::vector<G4VSolid*> fSolids;
+};
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 SYPDetectorConstruction::SYPDetectorConstruction()
 : G4VUserDetectorConstruction(),
-  fScoringVolume(0)
-{ }
+  fScoringVolume(0),
+  fCheckOverlaps(false),
+  fParameterisedChambers(false),
+  fForcedCollision(false),
+  fChamberParameterisation(0),
+  fMessenger(0),
+  fRetiredSolids(0),
+  fWindowOutPlacement(0)
+{
+  fMessenger = new SYPDetectorMessenger(this);
+  fRetiredSolids = new SYPRetiredSolids;
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 SYPDetectorConstruction::~SYPDetectorConstruction()
-{ }
+{
+  delete fMessenger;
+  delete fChamberParameterisation;
+  // the solids not yet deleted are left to the solid store
+  delete fRetiredSolids;
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-
 G4VPhysicalVolume* SYPDetectorConstruction::Construct()
 {
+  // Define materials
+  DefineMaterials();
+
+  // Define volumes
+  return DefineVolumes();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPDetectorConstruction::ConstructSDandField()
+{
+  if (!fForcedCollision) return;
+
+  // one operator per thread, attached again to the rebuilt volumes
+  static G4ThreadLocal G4BOptrForceCollision* forceCollision = 0;
+  if (!forceCollision)
+  {
+    forceCollision = new G4BOptrForceCollision("gamma", "forceCollision");
+  }
+
+  for (auto volume : *G4LogicalVolumeStore::GetInstance())
+  {
+    if (GetVolumeRole(volume) == kChamberVolume)
+    {
+      forceCollision->AttachTo(volume);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPDetectorConstruction::DefineMaterials()
+{
+  // the materials survive a geometry rebuild: define them once
+  if (G4Material::GetMaterial("Xe_48atm", false)) return;
+
   // Material definition
   G4NistManager* nistManager = G4NistManager::Instance();
 
@@ -75,19 +186,46 @@ G4VPhysicalVolume* SYPDetectorConstruction::Construct()
   // Xe-48atm
   new G4Material("Xe_48atm", z=54., a=131.2*g/mole,density= 0.3723*g/cm3,
                  kStateGas, 2.93*kelvin, 48*atmosphere);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-  // Option to switch on/off checking of volumes overlaps
+G4VPhysicalVolume* SYPDetectorConstruction::DefineVolumes()
+{
+  const SYPGeometryParameters& par = fParameters;
+
+  if (par.GetNofUnits() > SYPTally::kMaxNofUnits)
+  {
+    G4ExceptionDescription description;
+    description << par.GetNofUnits() << " chamber units requested, at most "
+                << SYPTally::kMaxNofUnits << " can be scored.";
+    G4Exception("SYPDetectorConstruction::DefineVolumes()", "SYPDetector001",
+                FatalErrorInArgument, description);
+  }
+
+  // Option to switch on/off checking of volumes overlaps;
+  // off by default, the geometry is checked by exampleB1 --check-geometry
   //
-  G4bool checkOverlaps = true;
+  G4bool checkOverlaps = fCheckOverlaps;
 
-  // Parameter
+  fRibPlacements.clear();
+  fSlicePlacements.clear();
+
+  // the chambers are parameterised only if their copy numbers allow it
+  G4bool parameterised = fParameterisedChambers;
+  if (parameterised && !SYPChamberParameterisation::IsApplicable(par))
+  {
+    G4Exception("SYPDetectorConstruction::DefineVolumes()", "SYPDetector003",
+                JustWarning,
+                "Chamber copy numbers are not 0 to N-1: chambers placed.");
+    parameterised = false;
+  }
 
-  G4double world_sizeX = 10*m; G4double world_sizeY = 10*m; G4double world_sizeZ = 10*m;
   //
-  G4Material* world_mat = nistManager->FindOrBuildMaterial("G4_AIR");
+  G4Material* world_mat = G4Material::GetMaterial("G4_AIR");
   G4Material* cham_mat = G4Material::GetMaterial("Xe_48atm");
   G4Material* shell_mat = G4Material::GetMaterial("StainlessSteel");
-  G4Material* electrodeSlice_mat = nistManager->FindOrBuildMaterial("95WNiFe");
+  G4Material* electrodeSlice_mat = G4Material::GetMaterial("95WNiFe");
 
   //
   // World
@@ -95,7 +233,7 @@ G4VPhysicalVolume* SYPDetectorConstruction::Construct()
 
   G4Box* solidWorld =    
     new G4Box("World",                       //its name
-       0.5*world_sizeX, 0.5*world_sizeY, 0.5*world_sizeZ);     //its size
+       0.5*par.worldSize, 0.5*par.worldSize, 0.5*par.worldSize); //its size
       
   G4LogicalVolume* logicWorld =                         
     new G4LogicalVolume(solidWorld,          //its solid
@@ -112,69 +250,41 @@ G4VPhysicalVolume* SYPDetectorConstruction::Construct()
                       0,                     //copy number
                       checkOverlaps);        //overlaps checking
 
-
   //
   // Shell: window front to insulating back
-  // dx = 235.5*mm dy1 = 163*mm dy2 = 169.1166*mm(point to point)
-  //
-  // generic trapezoid with optionally collapsing vertices
   //
+  G4LogicalVolume* logic_shell = new G4LogicalVolume
+          (MakeTrap("Shell", par.shellHalfZ, par.shellVertices),
+           shell_mat, "shell");
 
-  G4double shell_halfZ = 0.5*36*mm;
-  const std::vector<G4TwoVector>& shell_vertices =
-          {{0,81.5*mm},{235*mm, 84.5583*mm},
-           {235*mm,-84.5583*mm},{0,-81.5*mm},
-           {0,81.5*mm},{235*mm, 84.5583*mm},
-           {235*mm,-84.5583*mm},{0,-81.5*mm}};
+  new G4PVPlacement(0, G4ThreeVector(), logic_shell, "shell",
+                    logicWorld, false, 0, checkOverlaps);
 
-  G4GenericTrap* solid_shell =
-    new G4GenericTrap( "Shell", shell_halfZ, shell_vertices);
-
-  G4LogicalVolume* logic_shell =
-          new G4LogicalVolume(solid_shell,shell_mat,"shell");
-
-  G4VPhysicalVolume* phys_shell = new G4PVPlacement
-          (
-
-                  0,
-                  G4ThreeVector(),
-                  logic_shell,
-                  "shell",
-                  logicWorld,
-                  false,
-                  0,
-                  checkOverlaps
-
-          );
   //
   // working gas area
-  // window back (precisely: according to the side window end gasket) to insulating front
-  // z_start = 14.3887*mm z_end = 210.5*mm
   //
-  G4double gas_halfZ = 0.5*16*mm;
-  const std::vector<G4TwoVector>& gas_vertices =
-          {{14.3887*mm,79.5983*mm},{220.5*mm,82.3*mm},
-           {220.5*mm, -82.3*mm},{14.3887*mm,-79.5983*mm},
-           {14.3887*mm,79.5983*mm},{220.5*mm,82.3*mm},
-           {220.5*mm, -82.3*mm},{14.3887*mm,-79.5983*mm}};
-
-  G4GenericTrap* solid_gas =
-          new G4GenericTrap( "gas", gas_halfZ, gas_vertices);
+  G4VSolid* solid_gas = MakeTrap("gas", par.gasHalfZ, par.gasVertices);
+
+  // a parameterised volume must be the only daughter of its mother:
+  // the ribs are then cut out of the gas and placed in the shell
+  if (parameterised && !par.ribs.empty())
+  {
+    G4MultiUnion* solid_ribs = new G4MultiUnion("ribs");
+    G4Transform3D noTransform;
+    for (const auto& rib : par.ribs)
+    {
+      solid_ribs->AddNode(*MakeTrap("rib", par.ribHalfZ, rib.vertices),
+                          noTransform);
+    }
+    solid_ribs->Voxelize();
+    solid_gas = new G4SubtractionSolid("gas", solid_gas, solid_ribs);
+  }
 
   G4LogicalVolume* logic_gas = new G4LogicalVolume
-          (solid_gas,cham_mat,"gas");
-
-  G4VPhysicalVolume* phys_gas = new G4PVPlacement
-          (
-                  0,
-                  G4ThreeVector(),
-                  logic_gas,
-                  "gas",
-                  logic_shell,
-                  false,
-                  0,
-                  checkOverlaps
-          );
+          (solid_gas, cham_mat, "gas");
+
+  new G4PVPlacement(0, G4ThreeVector(), logic_gas, "gas",
+                    logic_shell, false, 0, checkOverlaps);
 
   // window2
   // there may be some spare room between rib and chamber,
@@ -184,784 +294,141 @@ G4VPhysicalVolume* SYPDetectorConstruction::Construct()
   // using GetPreStepPoint() && GetPostStepPoint() in
   // UserSteppingAction
   // the created window must be stuck to the chamber
-  // we may refer to some point used before
   //
   // window and chamber
-  G4double chamber_halfZ = 0.5*16*mm;
-  const std::vector<G4TwoVector>& chamberAndWindow_vertices =
-          {{-92.76855*mm,9.49997*mm},{92.76855*mm,9.80003*mm},
-           {92.76855*mm, -9.80003*mm},{-92.76855*mm,-9.49997*mm},
-           {-92.76855*mm,9.49997*mm},{92.76855*mm,9.80003*mm},
-           {92.76855*mm, -9.80003*mm},{-92.76855*mm,-9.49997*mm}};
-
-  G4GenericTrap* solid_chamberAndWindow = new G4GenericTrap
-          ("chamberAndWindow",chamber_halfZ,chamberAndWindow_vertices);
-
   G4LogicalVolume* logic_chamberAndWindow = new G4LogicalVolume
-          (solid_chamberAndWindow,cham_mat,"chamberAndWindow");
-
+          (MakeTrap("chamberAndWindow", par.chamberHalfZ,
+                    par.chamberAndWindowVertices),
+           cham_mat, "chamberAndWindow");
 
   // Chamber
   // contain electrode slice
-  //
-
-  // original location, centred at(0,0,0), need to be put in the right place with the gas
-  const std::vector<G4TwoVector>& chamber_vertices =
-          {{-92.751855*mm,9.499997*mm},{92.751855*mm, 9.800003*mm},
-           {92.751855*mm,-9.800003*mm},{-92.751855*mm,-9.499997*mm},
-           {-92.751855*mm,9.499997*mm},{92.751855*mm, 9.800003*mm},
-           {92.751855*mm,-9.800003*mm},{-92.751855*mm,-9.499997*mm}};
-
-  G4GenericTrap* solid_chamber = new G4GenericTrap
-          ("Chamber",chamber_halfZ,chamber_vertices);
-
+  // original location, centred at(0,0,0), placed in the gas below
   G4LogicalVolume* logic_chamber = new G4LogicalVolume
-          (solid_chamber,cham_mat,"Chamber");
+          (MakeTrap("Chamber", par.chamberHalfZ, par.chamberVertices),
+           cham_mat, "Chamber");
 
-  G4VPhysicalVolume* phys_chamber = new G4PVPlacement(
-
-                  0,
-                  G4ThreeVector(),
-                  logic_chamber,
-                  "Chamber",
-                  logic_chamberAndWindow,
-                  false,
-                  0,
-                  checkOverlaps
-          );
+  new G4PVPlacement(0, G4ThreeVector(), logic_chamber, "Chamber",
+                    logic_chamberAndWindow, false, 0, checkOverlaps);
 
   // divide a chamber into two parts
   // one chamber include two units
   // for easy to get copy number
-  const std::vector<G4TwoVector>& chamber_vertices_left_half =
-          {{-92.751855*mm,9.499997*mm},{92.751855*mm, 9.800003*mm},
-           {92.751855*mm,0*mm},{-92.751855*mm,0*mm},
-           {-92.751855*mm,9.499997*mm},{92.751855*mm, 9.800003*mm},
-           {92.751855*mm,0*mm},{-92.751855*mm,0*mm}};
-
-  const std::vector<G4TwoVector>& chamber_vertices_right_half =
-          {{-92.751855*mm,0*mm},{92.751855*mm, 0*mm},
-           {92.751855*mm,-9.800003*mm},{-92.751855*mm,-9.499997*mm},
-           {-92.751855*mm,0*mm},{92.751855*mm, 0*mm},
-           {92.751855*mm,-9.800003*mm},{-92.751855*mm,-9.499997*mm},};
-
-  G4GenericTrap* solid_chamber_left = new G4GenericTrap
-          ("chamber",chamber_halfZ,chamber_vertices_left_half);
-
-  G4LogicalVolume* logic_chamber_left = new G4LogicalVolume
-          (solid_chamber_left,cham_mat,"chamber");
-
-  G4GenericTrap* solid_chamber_right = new G4GenericTrap
-          ("chamber",chamber_halfZ,chamber_vertices_right_half);
-
-  G4LogicalVolume* logic_chamber_right = new G4LogicalVolume
-          (solid_chamber_right,cham_mat,"chamber");
-
-  G4VPhysicalVolume* phys_chamber_left = new G4PVPlacement
-          (
-                  0,
-                  G4ThreeVector(),
-                  logic_chamber_left,
-                  "chamber",
-                  logic_chamber,
-                  false,
-                  0,
-                  checkOverlaps
-                  );
-
-  G4VPhysicalVolume* phys_chamber_right = new G4PVPlacement
-          (
-                  0,
-                  G4ThreeVector(),
-                  logic_chamber_right,
-                  "chamber",
-                  logic_chamber,
-                  false,
-                  1,
-                  checkOverlaps
-                  );
+  const std::vector<G4TwoVector>& v = par.chamberVertices;
+  std::vector<G4TwoVector> chamber_vertices_half[2] =
+          {{v[0], v[1], G4TwoVector(v[2].x(),0), G4TwoVector(v[3].x(),0)},
+           {G4TwoVector(v[0].x(),0), G4TwoVector(v[1].x(),0), v[2], v[3]}};
+
+  G4LogicalVolume* logic_chamber_half[2];
+  for (G4int half = 0; half < 2; half++)
+  {
+    logic_chamber_half[half] = new G4LogicalVolume
+          (MakeTrap("chamber", par.chamberHalfZ, chamber_vertices_half[half]),
+           cham_mat, "chamber");
+
+    new G4PVPlacement(0, G4ThreeVector(), logic_chamber_half[half], "chamber",
+                      logic_chamber, false, half, checkOverlaps);
+  }
 
   // place electrode slice in chamber(half)
   // there are 2 kinds of electrode slice: ES and EC
   // differ in height: 12*mm and 16*mm
-  // total 8, 6 complete, 2 half
-
-  // 1st middle half (left)  ES
-  const std::vector<G4TwoVector>& electrode_slice1_left =
-          {{-92.75*mm,0.25*mm},{92.75*mm, 0.25*mm},
-           {92.75*mm,0*mm},{-92.75*mm,0*mm},
-           {-92.75*mm,0.25*mm},{92.75*mm, 0.25*mm},
-           {92.75*mm,0.*mm},{-92.75*mm,0.*mm}};
-
-  G4GenericTrap* solid_electrode_slice1_left = new G4GenericTrap
-          ("ES",chamber_halfZ,electrode_slice1_left);
-
-  G4LogicalVolume* logic_electrode_slice1_left = new G4LogicalVolume
-          (solid_electrode_slice1_left,electrodeSlice_mat,"ES");
-
-  G4VPhysicalVolume* phys_electrode_slice1_left = new G4PVPlacement
-            (
-                    0,
-                    G4ThreeVector(),
-                    logic_electrode_slice1_left,
-                    "ES",
-                    logic_chamber_left,
-                    false,
-                    30,
-                    checkOverlaps
-            );
-
-  // 2nd middle half (right)  ES
-  const std::vector<G4TwoVector>& electrode_slice2_right =
-          {{-92.75*mm,0.*mm},{92.75*mm, 0.*mm},
-           {92.75*mm,-0.25*mm},{-92.75*mm,-0.25*mm},
-           {-92.75*mm,0.*mm},{92.75*mm, 0.*mm},
-           {92.75*mm,-0.25*mm},{-92.75*mm,-0.25*mm}};
-
-  G4GenericTrap* solid_electrode_slice2_right = new G4GenericTrap
-          ("ES",chamber_halfZ,electrode_slice2_right);
-
-  G4LogicalVolume* logic_electrode_slice2_right = new G4LogicalVolume
-          (solid_electrode_slice2_right,electrodeSlice_mat,"ES");
-
-  G4VPhysicalVolume* phys_electrode_slice2_right = new G4PVPlacement
-          (
-                  0,
-                  G4ThreeVector(),
-                  logic_electrode_slice2_right,
-                  "ES",
-                  logic_chamber_right,
-                  false,
-                  31,
-                  checkOverlaps
-                  );
-
-  // 3rd slice EC
-
-  G4double EC_halfZ = 0.5*12*mm;
-  const std::vector<G4TwoVector>& electrode_slice3 =
-          {{-92.7503 *mm, 7.5625 *mm },
-           {92.7496 *mm, 7.7875 *mm },
-           {92.7502 *mm, 7.2875 *mm },
-           {-92.7497 *mm, 7.0625 *mm },
-           {-92.7503 *mm, 7.5625 *mm },
-           {92.7496 *mm, 7.7875 *mm },
-           {92.7502 *mm, 7.2875 *mm },
-           {-92.7497 *mm, 7.0625 *mm }};
-
-    G4GenericTrap* solid_electrode_slice3 = new G4GenericTrap
-            ("EC",EC_halfZ,electrode_slice3);
-
-    G4LogicalVolume* logic_electrode_slice3 = new G4LogicalVolume
-            (solid_electrode_slice3,electrodeSlice_mat,"EC");
-
-    G4VPhysicalVolume* phys_electrode_slice3 = new G4PVPlacement
-            (
-                    0,
-                    G4ThreeVector(),
-                    logic_electrode_slice3,
-                    "EC",
-                    logic_chamber_left,
-                    false,
-                    0,
-                    checkOverlaps
-            );
-
-  // 4th slice ES
-  const std::vector<G4TwoVector>& electrode_slice4 =
-          {{-92.7501 *mm, 5.125 *mm },
-           {92.7498 *mm, 5.275 *mm },
-           {92.7502 *mm, 4.775 *mm },
-           {-92.7498 *mm, 4.625 *mm },
-           {-92.7501 *mm, 5.125 *mm },
-           {92.7498 *mm, 5.275 *mm },
-           {92.7502 *mm, 4.775 *mm },
-           {-92.7498 *mm, 4.625 *mm }};
-
-  G4GenericTrap* solid_electrode_slice4 = new G4GenericTrap
-          ("ES",chamber_halfZ,electrode_slice4);
-
-  G4LogicalVolume* logic_electrode_slice4 = new G4LogicalVolume
-          (solid_electrode_slice4,electrodeSlice_mat,"ES");
-
-  G4VPhysicalVolume* phys_electrode_slice4 = new G4PVPlacement
-          (
-                  0,
-                  G4ThreeVector(),
-                  logic_electrode_slice4,
-                  "ES",
-                  logic_chamber_left,
-                  false,
-                  1,
-                  checkOverlaps
-            );
-
-  // 5th slice EC
-  const std::vector<G4TwoVector>& electrode_slice5 =
-          {{-92.7501 *mm, 2.6875 *mm },{92.7499 *mm, 2.7625 *mm },
-           {92.7501 *mm, 2.2625 *mm },{-92.7499 *mm, 2.1875 *mm },
-           {-92.7501 *mm, 2.6875 *mm },{92.7499 *mm, 2.7625 *mm },
-           {92.7501 *mm, 2.2625 *mm },{-92.7499 *mm, 2.1875 *mm }};
-
-  G4GenericTrap* solid_electrode_slice5 = new G4GenericTrap
-          ("EC",EC_halfZ,electrode_slice5);
-
-  G4LogicalVolume* logic_electrode_slice5 = new G4LogicalVolume
-          (solid_electrode_slice5,electrodeSlice_mat,"EC");
-
-  G4VPhysicalVolume* phys_electrode_slice5 = new G4PVPlacement
-          (
-                  0,
-                  G4ThreeVector(),
-                  logic_electrode_slice5,
-                  "EC",
-                  logic_chamber_left,
-                  false,
-                  2,
-                  checkOverlaps
-            );
-
-  // 6th slice EC in right half
-  const std::vector<G4TwoVector>& electrode_slice6 =
-            {{-92.7499 *mm, -2.1875 *mm },
-             {92.7501 *mm, -2.2625 *mm },
-             {92.7499 *mm, -2.7625 *mm },
-             {-92.7501 *mm, -2.6875 *mm },
-             {-92.7499 *mm, -2.1875 *mm },
-             {92.7501 *mm, -2.2625 *mm },
-             {92.7499 *mm, -2.7625 *mm },
-             {-92.7501 *mm, -2.6875 *mm }};
-
-    G4GenericTrap* solid_electrode_slice6 = new G4GenericTrap
-            ("EC",EC_halfZ,electrode_slice6);
-
-    G4LogicalVolume* logic_electrode_slice6 = new G4LogicalVolume
-            (solid_electrode_slice6,electrodeSlice_mat,"EC");
-
-    G4VPhysicalVolume* phys_electrode_slice6 = new G4PVPlacement
-            (
-                    0,
-                    G4ThreeVector(),
-                    logic_electrode_slice6,
-                    "EC",
-                    logic_chamber_right,
-                    false,
-                    4,
-                    checkOverlaps
-            );
-
-  // 7th slice ES in right half
-  const std::vector<G4TwoVector>& electrode_slice7 =
-          {{-92.7498 *mm, -4.625 *mm },{92.7502 *mm, -4.775 *mm },
-           {92.7498 *mm, -5.275 *mm },{-92.7502 *mm, -5.125 *mm },
-           {-92.7498 *mm, -4.625 *mm },{92.7502 *mm, -4.775 *mm },
-           {92.7498 *mm, -5.275 *mm },{-92.7502 *mm, -5.125 *mm }};
-
-  G4GenericTrap* solid_electrode_slice7 = new G4GenericTrap
-          ("ES",chamber_halfZ,electrode_slice7);
-
-  G4LogicalVolume* logic_electrode_slice7 = new G4LogicalVolume
-          (solid_electrode_slice7,electrodeSlice_mat,"ES");
-
-  G4VPhysicalVolume* phys_electrode_slice7 = new G4PVPlacement
-          (
-                  0,
-                  G4ThreeVector(),
-                  logic_electrode_slice7,
-                  "ES",
-                  logic_chamber_right,
-                  false,
-                  5,
-                  checkOverlaps
-            );
-
-  // 8th slice EC in right half
-  const std::vector<G4TwoVector>& electrode_slice8 =
-          {{-92.7497 *mm, -7.0625 *mm },{92.7502 *mm, -7.2875 *mm },
-           {92.7496 *mm, -7.7875 *mm },{-92.7503 *mm, -7.5625 *mm },
-           {-92.7497 *mm, -7.0625 *mm },{92.7502 *mm, -7.2875 *mm },
-           {92.7496 *mm, -7.7875 *mm },{-92.7503 *mm, -7.5625 *mm }};
-
-  G4GenericTrap* solid_electrode_slice8 = new G4GenericTrap
-          ("EC",EC_halfZ,electrode_slice8);
-
-  G4LogicalVolume* logic_electrode_slice8 = new G4LogicalVolume
-          (solid_electrode_slice8,electrodeSlice_mat,"EC");
-
-  G4VPhysicalVolume* phys_electrode_slice8 = new G4PVPlacement
-          (
-                  0,
-                  G4ThreeVector(),
-                  logic_electrode_slice8,
-                  "EC",
-                  logic_chamber_right,
-                  false,
-                  6,
-                  checkOverlaps
-            );
-
-  // place 8 chamberAndWindow in gas
-  // from ---- the original location
-  // middle ES location ---- left below, right below and right up
-  G4Point3D v1 = { -92.75*mm,0.25*mm,8*mm },
-            v2 = {-92.75*mm,-0.25*mm,8*mm},
-            v3 = {92.75*mm,-0.25*mm,8*mm};
-
-  // to ---- the transformed location
-  // this is the chamber in the left middle, copy number = 3
-  G4Point3D v1_after1 = {16.4996*mm,10.2664*mm,8*mm},
-            v2_after1 = {16.5004*mm,9.7664*mm,8*mm},
-            v3_after1 = {202*mm,10.0791*mm,8*mm};
-
-  G4Transform3D trans_cham1 =
-          G4Transform3D
-          (v1,v2,v3,v1_after1,v2_after1,v3_after1);
-
-  G4VPhysicalVolume* phys_chamber1 = new G4PVPlacement
-          (
-                  trans_cham1,
-                  logic_chamberAndWindow,
-                  "chamberAndWindow",
-                  logic_gas,
-                  false,
-                  3,
-                  checkOverlaps
-                  );
-
-  // to ---- the transformed location
-  // copy number = 2
-  G4Point3D v1_after2 = {16.4987*mm,30.2992*mm,8*mm},
-            v2_after2 = {16.5012*mm,29.7992*mm,8*mm},
-            v3_after2 = {201.999*mm,30.7373*mm,8*mm};
-
-  G4Transform3D trans_cham2 =
-          G4Transform3D
-          (v1,v2,v3,v1_after2,v2_after2,v3_after2);
-
-  G4VPhysicalVolume* phys_chamber2 = new G4PVPlacement
-          (
-                  trans_cham2,
-                  logic_chamberAndWindow,
-                  "chamberAndWindow",
-                  logic_gas,
-                  false,
-                  2,
-                  checkOverlaps
-            );
-
-  // copy number = 1
-  G4Point3D v1_after3 = {16.4978*mm,50.332*mm,8*mm},
-            v2_after3 = {16.502*mm,49.832*mm,8*mm},
-            v3_after3 = {201.995*mm,51.3955*mm,8*mm};
-
-  G4Transform3D trans_cham3 =
-          G4Transform3D
-          (v1,v2,v3,v1_after3,v2_after3,v3_after3);
-
-  G4VPhysicalVolume* phys_chamber3 = new G4PVPlacement
-          (
-                  trans_cham3,
-                  logic_chamberAndWindow,
-                  "chamberAndWindow",
-                  logic_gas,
-                  false,
-                  1,
-                  checkOverlaps
-            );
-
-  // copy number = 0
-  G4Point3D v1_after4 = {16.4969*mm,70.3724*mm,8*mm},
-            v2_after4 = {16.5028*mm,69.8725*mm,8*mm},
-            v3_after4 = {201.99*mm,72.0464*mm,8*mm};
-
-  G4Transform3D trans_cham4 =
-          G4Transform3D
-          (v1,v2,v3,v1_after4,v2_after4,v3_after4);
-
-  G4VPhysicalVolume* phys_chamber4 = new G4PVPlacement
-          (
-                  trans_cham4,
-                  logic_chamberAndWindow,
-                  "chamberAndWindow",
-                  logic_gas,
-                  false,
-                  0,
-                  checkOverlaps
-            );
-
-  // copy number = 4
-  G4Point3D v1_after5 = {16.5004*mm,-9.7664*mm,8*mm},
-            v2_after5 = {16.4996*mm,-10.2664*mm,8*mm},
-            v3_after5 = {201.999*mm,-10.5791*mm,8*mm};
-
-  G4Transform3D trans_cham5 =
-          G4Transform3D
-          (v1,v2,v3,v1_after5,v2_after5,v3_after5);
-
-  G4VPhysicalVolume* phys_chamber5 = new G4PVPlacement
-          (
-                  trans_cham5,
-                  logic_chamberAndWindow,
-                  "chamberAndWindow",
-                  logic_gas,
-                  false,
-                  4,
-                  checkOverlaps
-            );
-
-  // copy number = 5
-  G4Point3D v1_after6 = {16.5012*mm,-29.7992*mm,8*mm},
-            v2_after6 = {16.4987*mm,-30.2992*mm,8*mm},
-            v3_after6 = {201.996*mm,-31.237*mm,8*mm};
-
-  G4Transform3D trans_cham6 =
-          G4Transform3D
-          (v1,v2,v3,v1_after6,v2_after6,v3_after6);
-
-  G4VPhysicalVolume* phys_chamber6 = new G4PVPlacement
-          (
-                  trans_cham6,
-                  logic_chamberAndWindow,
-                  "chamberAndWindow",
-                  logic_gas,
-                  false,
-                  5,
-                  checkOverlaps
-                  );
-
-  // copy number = 6
-  G4Point3D v1_after7 = {16.502*mm,-49.832*mm,8*mm},
-            v2_after7 = {16.4978*mm,-50.3319*mm,8*mm},
-            v3_after7 = {201.991*mm,-51.8954*mm,8*mm};
-
-  G4Transform3D trans_cham7 =
-          G4Transform3D
-          (v1,v2,v3,v1_after7,v2_after7,v3_after7);
-
-  G4VPhysicalVolume* phys_chamber7 = new G4PVPlacement
-          (
-                  trans_cham7,
-                  logic_chamberAndWindow,
-                  "chamberAndWindow",
-                  logic_gas,
-                  false,
-                  6,
-                  checkOverlaps
-            );
-
-  // copy number = 7
-  G4Point3D v1_after8 = {16.5028*mm,-69.8724*mm,8*mm},
-            v2_after8 = {16.4969*mm,-70.3723*mm,8*mm},
-            v3_after8 = {201.984*mm,-72.5463*mm,8*mm};
-
-  G4Transform3D trans_cham8 =
-          G4Transform3D
-          (v1,v2,v3,v1_after8,v2_after8,v3_after8);
-
-  G4VPhysicalVolume* phys_chamber8 = new G4PVPlacement
-          (
-                  trans_cham8,
-                  logic_chamberAndWindow,
-                  "chamberAndWindow",
-                  logic_gas,
-                  false,
-                  7,
-                  checkOverlaps
-            );
-
-  // 7 ribs
-  // middle  copy number = 4
-  const std::vector<G4TwoVector>& rib4 =
-          {{15.25*mm,0.5*mm},
-           {208.25*mm,0.5*mm},
-           {208.25*mm,-0.5*mm},
-           {15.25*mm, -0.5*mm},
-           {15.25*mm,0.5*mm},
-           {208.25*mm,0.5*mm},
-           {208.25*mm,-0.5*mm},
-           {15.25*mm, -0.5*mm}
-           };
-
-  G4GenericTrap* solid_rib4 = new G4GenericTrap
-          ("rib",chamber_halfZ,rib4);
-
-  G4LogicalVolume* logic_rib4 = new G4LogicalVolume
-          (solid_rib4,shell_mat,"rib");
-
-  G4VPhysicalVolume* phys_rib4 = new G4PVPlacement
-          (
-                  0,
-                  G4ThreeVector(),
-                  logic_rib4,
-                  "rib",
-                  logic_gas,
-                  false,
-                  3,
-                  checkOverlaps
-                  );
-
-  // middle  copy number = 3
-  const std::vector<G4TwoVector>& rib3 =
-          {{15.2494 *mm, 20.5286 *mm },
-           {208.248 *mm, 21.1793 *mm },
-           {208.252 *mm, 20.1793 *mm },
-           {15.2528 *mm, 19.5286 *mm },
-           {15.2494 *mm, 20.5286 *mm },
-           {208.248 *mm, 21.1793 *mm },
-           {208.252 *mm, 20.1793 *mm },
-           {15.2528 *mm, 19.5286 *mm }
-            };
-
-  G4GenericTrap* solid_rib3 = new G4GenericTrap
-          ("rib",chamber_halfZ,rib3);
-
-  G4LogicalVolume* logic_rib3 = new G4LogicalVolume
-          (solid_rib3,shell_mat,"rib");
-
-  G4VPhysicalVolume* phys_rib3 = new G4PVPlacement
-          (
-                  0,
-                  G4ThreeVector(),
-                  logic_rib3,
-                  "rib",
-                  logic_gas,
-                  false,
-                  2,
-                  checkOverlaps
-            );
-
-  // middle  copy number = 2
-  const std::vector<G4TwoVector>& rib2 =
-          {{15.249 *mm, 40.5572 *mm },
-           {208.245 *mm, 41.8586 *mm },
-           {208.251 *mm, 40.8586 *mm },
-           {15.2557 *mm, 39.5572 *mm },
-           {15.249 *mm, 40.5572 *mm },
-           {208.245 *mm, 41.8586 *mm },
-           {208.251 *mm, 40.8586 *mm },
-           {15.2557 *mm, 39.5572 *mm }
-          };
-
-  G4GenericTrap* solid_rib2 = new G4GenericTrap
-            ("rib",chamber_halfZ,rib2);
-
-  G4LogicalVolume* logic_rib2 = new G4LogicalVolume
-          (solid_rib2,shell_mat,"rib");
-
-  G4VPhysicalVolume* phys_rib2 = new G4PVPlacement
-          (
-                  0,
-                  G4ThreeVector(),
-                  logic_rib2,
-                  "rib",
-                  logic_gas,
-                  false,
-                  1,
-                  checkOverlaps
-            );
-
-  // middle  copy number = 1
-  const std::vector<G4TwoVector>& rib1 =
-          {{15.2502 *mm, 60.5858 *mm },
-           {208.24 *mm, 62.5378 *mm },
-           {208.25 *mm, 61.5378 *mm },
-           {15.2603 *mm, 59.5859 *mm },
-           {15.2502 *mm, 60.5858 *mm },
-           {208.24 *mm, 62.5378 *mm },
-           {208.25 *mm, 61.5378 *mm },
-           {15.2603 *mm, 59.5859 *mm }
-          };
-  //
-  G4GenericTrap* solid_rib1 = new G4GenericTrap
-            ("rib",chamber_halfZ,rib1);
-
-  G4LogicalVolume* logic_rib1 = new G4LogicalVolume
-          (solid_rib1,shell_mat,"rib");
-
-  G4VPhysicalVolume* phys_rib1 = new G4PVPlacement
-          (
-                  0,
-                  G4ThreeVector(),
-                  logic_rib1,
-                  "rib",
-                  logic_gas,
-                  false,
-                  1,
-                  checkOverlaps
-            );
-
-  // middle  copy number = 4
-  const std::vector<G4TwoVector>& rib5 =
-          {{15.2494 *mm, -20.5286 *mm },
-           {208.248 *mm, -21.1793 *mm },
-           {208.252 *mm, -20.1793 *mm },
-           {15.2528 *mm, -19.5286 *mm },
-           {15.2494 *mm, -20.5286 *mm },
-           {208.248 *mm, -21.1793 *mm },
-           {208.252 *mm, -20.1793 *mm },
-           {15.2528 *mm, -19.5286 *mm }
-          };
-
-  G4GenericTrap* solid_rib5 = new G4GenericTrap
-          ("rib",chamber_halfZ,rib5);
-
-  G4LogicalVolume* logic_rib5 = new G4LogicalVolume
-          (solid_rib5,shell_mat,"rib");
-
-  G4VPhysicalVolume* phys_rib5 = new G4PVPlacement
-          (
-                  0,
-                  G4ThreeVector(),
-                  logic_rib5,
-                  "rib",
-                  logic_gas,
-                  false,
-                  4,
-                  checkOverlaps
-            );
-
-  // middle  copy number = 5
-  const std::vector<G4TwoVector>& rib6 =
-            {{15.249 *mm, -40.5572 *mm },
-             {208.245 *mm, -41.8586 *mm },
-             {208.251 *mm, -40.8586 *mm },
-             {15.2557 *mm, -39.5572 *mm },
-             {15.249 *mm, -40.5572 *mm },
-             {208.245 *mm, -41.8586 *mm },
-             {208.251 *mm, -40.8586 *mm },
-             {15.2557 *mm, -39.5572 *mm }
-            };
-
-  G4GenericTrap* solid_rib6 = new G4GenericTrap
-          ("rib",chamber_halfZ,rib6);
-
-  G4LogicalVolume* logic_rib6 = new G4LogicalVolume
-          (solid_rib6,shell_mat,"rib");
-
-  G4VPhysicalVolume* phys_rib6 = new G4PVPlacement
-          (
-                  0,
-                  G4ThreeVector(),
-                  logic_rib6,
-                  "rib",
-                  logic_gas,
-                  false,
-                  1,
-                  checkOverlaps
-            );
-
-  // middle  copy number = 6
-  const std::vector<G4TwoVector>& rib7 =
-            {{15.2502 *mm, -60.5858 *mm },
-             {208.24 *mm, -62.5378 *mm },
-             {208.25 *mm, -61.5378 *mm },
-             {15.2603 *mm, -59.5859 *mm },
-             {15.2502 *mm, -60.5858 *mm },
-             {208.24 *mm, -62.5378 *mm },
-             {208.25 *mm, -61.5378 *mm },
-             {15.2603 *mm, -59.5859 *mm }
-            };
-  //
-  G4GenericTrap* solid_rib7 = new G4GenericTrap
-          ("rib",chamber_halfZ,rib7);
-
-  G4LogicalVolume* logic_rib7 = new G4LogicalVolume
-          (solid_rib7,shell_mat,"rib");
-
-  G4VPhysicalVolume* phys_rib7 = new G4PVPlacement
-          (
-                  0,
-                  G4ThreeVector(),
-                  logic_rib7,
-                  "rib",
-                  logic_gas,
-                  false,
-                  6,
-                  checkOverlaps
-            );
+  for (const auto& slice : par.slices)
+  {
+    G4double halfZ = (slice.name == "EC") ? par.ECHalfZ : par.ESHalfZ;
+    G4LogicalVolume* logic_slice = new G4LogicalVolume
+          (MakeTrap(slice.name, halfZ, slice.vertices),
+           electrodeSlice_mat, slice.name);
+
+    fSlicePlacements.push_back
+      (new G4PVPlacement(0, G4ThreeVector(), logic_slice, slice.name,
+                         logic_chamber_half[slice.half], false, slice.copyNo,
+                         checkOverlaps));
+  }
+
+  // place the chamberAndWindow in gas,
+  // each from the three reference points to their images,
+  // as one parameterised volume or as placements
+  delete fChamberParameterisation;
+  fChamberParameterisation = 0;
+  if (parameterised)
+  {
+    fChamberParameterisation = new SYPChamberParameterisation(par);
+    new G4PVParameterised("chamberAndWindow", logic_chamberAndWindow,
+                          logic_gas, kUndefined,
+                          fChamberParameterisation->GetNofChambers(),
+                          fChamberParameterisation, checkOverlaps);
+  }
+  else for (const auto& placement : par.chambers)
+  {
+    G4Transform3D trans_cham
+          (par.chamberReference[0], par.chamberReference[1],
+           par.chamberReference[2],
+           placement.to[0], placement.to[1], placement.to[2]);
+
+    new G4PVPlacement(trans_cham, logic_chamberAndWindow, "chamberAndWindow",
+                      logic_gas, false, placement.copyNo, checkOverlaps);
+  }
+
+  // ribs between the chambers
+  G4LogicalVolume* logic_ribMother = parameterised ? logic_shell : logic_gas;
+  for (const auto& rib : par.ribs)
+  {
+    G4LogicalVolume* logic_rib = new G4LogicalVolume
+          (MakeTrap("rib", par.ribHalfZ, rib.vertices), shell_mat, "rib");
+
+    fRibPlacements.push_back
+      (new G4PVPlacement(0, G4ThreeVector(), logic_rib, "rib",
+                         logic_ribMother, false, rib.copyNo, checkOverlaps));
+  }
 
   // window slice
   // within the shell
-  G4double window_half_sizeX = 0.5*0.1*mm,
-  window_half_sizeY = 0.5*163*mm,
-  window_half_sizeZ = 0.5*20*mm;
-
   G4Box* solid_window = new G4Box
-          ("window",window_half_sizeX,
-           window_half_sizeY,window_half_sizeZ);
+          ("window", par.windowHalfSize.x(),
+           par.windowHalfSize.y(), par.windowHalfSize.z());
 
-  // need to be update later
   G4LogicalVolume* logic_window = new G4LogicalVolume
           (solid_window,shell_mat,"window");
 
-  //
-  G4ThreeVector window_pos = G4ThreeVector (0.05*mm,0,0);
-  G4VPhysicalVolume* phys_window = new G4PVPlacement
-          (
-                  0,
-                  window_pos,
-                  logic_window,
-                  "window",
-                  logic_shell,
-                  false,
-                  0,
-                  checkOverlaps
-            );
+  new G4PVPlacement(0, par.windowPosition, logic_window, "window",
+                    logic_shell, false, 0, checkOverlaps);
 
   // outside the shell
-  G4double window_half_sizeX_out = 0.5*0.4*mm,
-           window_half_sizeY_out = 0.5*163*mm,
-           window_half_sizeZ_out = 0.5*20*mm;
-
   G4Box* solid_window_out = new G4Box
-          ("window",window_half_sizeX_out,
-           window_half_sizeY_out,window_half_sizeZ_out);
+          ("window", par.windowOutHalfSize.x(),
+           par.windowOutHalfSize.y(), par.windowOutHalfSize.z());
 
   G4LogicalVolume* logic_window_out = new G4LogicalVolume
           (solid_window_out,shell_mat,"window");
 
-  //
-  G4ThreeVector window_pos_out = G4ThreeVector (-0.2*mm,0,0);
-  G4VPhysicalVolume* phys_window_out = new G4PVPlacement
-          (
-                  0,
-                  window_pos_out,
-                  logic_window_out,
-                  "window",
-                  logicWorld,
-                  false,
-                  0,
-                  checkOverlaps
-            );
+  fWindowOutPlacement =
+    new G4PVPlacement(0, par.windowOutPosition, logic_window_out, "window",
+                      logicWorld, false, 0, checkOverlaps);
 
   // dig a hole in window
-  G4double hole_sizeX = 0.5*13.8*mm;
-  G4double hole_sizeY = 0.5*160*mm;
-  G4double hole_sizeZ = 0.5*10*mm;
-
   G4Box* solid_hole = new G4Box
-          ("hole",hole_sizeX,hole_sizeY,hole_sizeZ);
+          ("hole", par.holeHalfSize.x(),
+           par.holeHalfSize.y(), par.holeHalfSize.z());
 
   G4LogicalVolume* logic_hole = new G4LogicalVolume
           (solid_hole,world_mat,"hole");
 
-  G4ThreeVector hole_pos = G4ThreeVector (7*mm,0*mm,0*mm);
-  G4VPhysicalVolume* phy_hole = new G4PVPlacement
-          (
-                  0,
-                  hole_pos,
-                  logic_hole,
-                  "hole",
-                  logic_shell,
-                  false,
-                  0,
-                  checkOverlaps
-                  );
+  new G4PVPlacement(0, par.holePosition, logic_hole, "hole",
+                    logic_shell, false, 0, checkOverlaps);
 
   // Set working gas as scoring volume
   //
   fScoringVolume = logic_shell;
 
+  // Classify the volumes for the stepping action
+  //
+  BuildVolumeRoles();
+
+  // Regions with their own production cuts
+  //
+  DefineRegions();
+
   //
   //always return the physical World
   //
@@ -969,3 +436,260 @@ G4VPhysicalVolume* SYPDetectorConstruction::Construct()
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPDetectorConstruction::SetParameters
+  (const SYPGeometryParameters& parameters)
+{
+  fParameters = parameters;
+  RebuildGeometry();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPDetectorConstruction::SetParameterisedChambers(G4bool parameterised)
+{
+  if (parameterised == fParameterisedChambers) return;
+
+  fParameterisedChambers = parameterised;
+  RebuildGeometry();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPDetectorConstruction::RebuildGeometry()
+{
+  // once built, the geometry is rebuilt at the next run
+  if (G4StateManager::GetStateManager()->GetCurrentState() != G4State_PreInit)
+  {
+    // the volumes are deleted now, with the replaced solids
+    fRibPlacements.clear();
+    fSlicePlacements.clear();
+    fWindowOutPlacement = 0;
+    fRetiredSolids->Forget();
+    G4RunManager::GetRunManager()->ReinitializeGeometry(true);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SYPDetectorConstruction::LoadParameters(const G4String& fileName)
+{
+  const SYPGeometryParameters* parameters
+    = SYPGeometryParameters::Load(fileName);
+  if (!parameters) return false;
+
+  SetParameters(*parameters);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPDetectorConstruction::SetRegularArray(G4int nofChambers,
+                                              G4double pitch)
+{
+  SYPGeometryParameters parameters = fParameters;
+  if (!parameters.SetRegularArray(nofChambers, pitch))
+  {
+    G4ExceptionDescription description;
+    description << "Regular array of " << nofChambers << " chambers of "
+                << pitch/mm << " mm refused: it does not fit in the shell.";
+    G4Exception("SYPDetectorConstruction::SetRegularArray()",
+                "SYPDetector002", JustWarning, description);
+    return;
+  }
+  SetParameters(parameters);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPDetectorConstruction::SetRibThickness(G4double thickness)
+{
+  if (!fParameters.SetRibThickness(thickness))
+  {
+    G4ExceptionDescription description;
+    description << "Rib thickness " << thickness/mm << " mm refused:"
+                << " the ribs would overlap the chambers.";
+    G4Exception("SYPDetectorConstruction::SetRibThickness()",
+                "SYPDetector002", JustWarning, description);
+    return;
+  }
+  if (fRibPlacements.empty()) return;  // built with the new value
+
+  // the ribs are also cut out of the gas of the parameterised chambers
+  if (fChamberParameterisation)
+  {
+    RebuildGeometry();
+    return;
+  }
+
+  G4Timer timer;
+  timer.Start();
+  for (std::size_t i = 0; i < fRibPlacements.size(); i++)
+  {
+    ReplaceSolid(fRibPlacements[i],
+                 MakeTrap("rib", fParameters.ribHalfZ,
+                          fParameters.ribs[i].vertices));
+  }
+  timer.Stop();
+  GeometryUpdated(fRibPlacements, timer.GetRealElapsed());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPDetectorConstruction::SetSlicePitch(G4double pitch)
+{
+  if (!fParameters.SetSlicePitch(pitch))
+  {
+    G4ExceptionDescription description;
+    description << "Slice pitch " << pitch/mm << " mm refused:"
+                << " the slices would overlap or leave their half-chamber.";
+    G4Exception("SYPDetectorConstruction::SetSlicePitch()",
+                "SYPDetector002", JustWarning, description);
+    return;
+  }
+  if (fSlicePlacements.empty()) return;
+
+  G4Timer timer;
+  timer.Start();
+  for (std::size_t i = 0; i < fSlicePlacements.size(); i++)
+  {
+    const SYPElectrodeSlice& slice = fParameters.slices[i];
+    G4double halfZ = (slice.name == "EC") ? fParameters.ECHalfZ
+                                          : fParameters.ESHalfZ;
+    ReplaceSolid(fSlicePlacements[i],
+                 MakeTrap(slice.name, halfZ, slice.vertices));
+  }
+  timer.Stop();
+  GeometryUpdated(fSlicePlacements, timer.GetRealElapsed());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPDetectorConstruction::SetWindowThickness(G4double thickness)
+{
+  if (!fParameters.SetWindowThickness(thickness))
+  {
+    G4ExceptionDescription description;
+    description << "Window thickness " << thickness/mm << " mm refused.";
+    G4Exception("SYPDetectorConstruction::SetWindowThickness()",
+                "SYPDetector002", JustWarning, description);
+    return;
+  }
+  if (!fWindowOutPlacement) return;
+
+  G4Timer timer;
+  timer.Start();
+  const G4ThreeVector& halfSize = fParameters.windowOutHalfSize;
+  ReplaceSolid(fWindowOutPlacement,
+               new G4Box("window", halfSize.x(), halfSize.y(), halfSize.z()));
+  fWindowOutPlacement->SetTranslation(fParameters.windowOutPosition);
+  timer.Stop();
+  GeometryUpdated(std::vector<G4VPhysicalVolume*>(1, fWindowOutPlacement),
+                  timer.GetRealElapsed());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPDetectorConstruction::ReplaceSolid(G4VPhysicalVolume* placement,
+                                           G4VSolid* solid)
+{
+  // the workers may still point to the old solid until the next run
+  G4LogicalVolume* volume = placement->GetLogicalVolume();
+  fRetiredSolids->Retire(volume->GetSolid());
+  volume->SetSolid(solid);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPDetectorConstruction::GeometryUpdated
+  (const std::vector<G4VPhysicalVolume*>& placements, G4double realTime)
+{
+  if (fCheckOverlaps)
+  {
+    for (auto placement : placements) placement->CheckOverlaps();
+  }
+
+  // only the navigation voxels are rebuilt at the next run
+  G4RunManager::GetRunManager()->GeometryHasBeenModified();
+
+  G4cout << " Geometry updated: " << placements.size()
+         << " solids replaced in " << realTime*1000. << " ms" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPDetectorConstruction::BuildVolumeRoles()
+{
+  fVolumeRoles.clear();
+  fPathVolumes.clear();
+
+  G4LogicalVolumeStore* store = G4LogicalVolumeStore::GetInstance();
+  for (auto volume : *store)
+  {
+    const G4String& name = volume->GetName();
+    SYPVolumeRole role = kOtherVolume;
+    if (name == "chamberAndWindow") role = kChamberAndWindowVolume;
+    else if (name == "chamber") role = kChamberVolume;
+    else if (name == "EC" || name == "ES" || name == "rib" || name == "shell")
+      role = kMetalVolume;
+
+    if (role != kOtherVolume) fVolumeRoles[volume] = role;
+
+    // and the kind of metal for the paths of the ray casting
+    G4int pathVolume = -1;
+    if (name == "shell") pathVolume = kPathShell;
+    else if (name == "window") pathVolume = kPathWindow;
+    else if (name == "rib") pathVolume = kPathRib;
+    else if (name == "EC") pathVolume = kPathEC;
+    else if (name == "ES") pathVolume = kPathES;
+
+    if (pathVolume >= 0) fPathVolumes[volume] = pathVolume;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPDetectorConstruction::DefineRegions()
+{
+  // the regions outlive a rebuild of the geometry, the deleted volumes
+  // leave them; the cuts are set with /run/setCutForRegion Gas|Metal
+  G4RegionStore* regionStore = G4RegionStore::GetInstance();
+  G4Region* gasRegion = regionStore->FindOrCreateRegion("Gas");
+  G4Region* metalRegion = regionStore->FindOrCreateRegion("Metal");
+
+  // the gas holds the chambers; the ribs and slices inside the gas
+  // and the outer window in the world are metal again
+  G4LogicalVolumeStore* store = G4LogicalVolumeStore::GetInstance();
+  for (auto volume : *store)
+  {
+    const G4String& name = volume->GetName();
+    if (name == "gas")
+    {
+      gasRegion->AddRootLogicalVolume(volume);
+    }
+    else if (GetVolumeRole(volume) == kMetalVolume || name == "window")
+    {
+      metalRegion->AddRootLogicalVolume(volume);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPVolumeRole SYPDetectorConstruction::GetVolumeRole
+  (const G4LogicalVolume* volume) const
+{
+  auto it = fVolumeRoles.find(volume);
+  return (it == fVolumeRoles.end()) ? kOtherVolume : it->second;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int SYPDetectorConstruction::GetPathVolume
+  (const G4LogicalVolume* volume) const
+{
+  auto it = fPathVolumes.find(volume);
+  return (it == fPathVolumes.end()) ? -1 : it->second;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,181 @@
+
+/// \file SYPDetectorMessenger.cc
+/// \brief Implementation of the SYPDetectorMessenger class
+
+#include "SYPDetectorMessenger.hh"
+#include "SYPDetectorConstruction.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UnitsTable.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPDetectorMessenger::SYPDetectorMessenger(SYPDetectorConstruction* detector)
+: G4UImessenger(),
+  fDetector(detector)
+{
+  fDirectory = new G4UIdirectory("/SYP/geometry/");
+  fDirectory->SetGuidance("Geometry of the chamber array.");
+
+  fLoadCmd = new G4UIcmdWithAString("/SYP/geometry/load", this);
+  fLoadCmd->SetGuidance("Read the geometry parameters from a file.");
+  fLoadCmd->SetGuidance("The geometry is rebuilt at the next run.");
+  fLoadCmd->SetParameterName("fileName", false);
+  fLoadCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fLoadCmd->SetToBeBroadcasted(false);
+
+  fSaveCmd = new G4UIcmdWithAString("/SYP/geometry/save", this);
+  fSaveCmd->SetGuidance("Write the current geometry parameters to a file.");
+  fSaveCmd->SetParameterName("fileName", false);
+  fSaveCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fSaveCmd->SetToBeBroadcasted(false);
+
+  fRegularCmd = new G4UIcommand("/SYP/geometry/regular", this);
+  fRegularCmd->SetGuidance("Generate a regular fan of chambers and ribs.");
+  fRegularCmd->SetGuidance("The geometry is rebuilt at the next run.");
+  G4UIparameter* nofChambersPrm = new G4UIparameter("nofChambers", 'i', false);
+  nofChambersPrm->SetParameterRange("nofChambers > 0");
+  fRegularCmd->SetParameter(nofChambersPrm);
+  G4UIparameter* pitchPrm = new G4UIparameter("pitch", 'd', false);
+  pitchPrm->SetParameterRange("pitch > 0.");
+  fRegularCmd->SetParameter(pitchPrm);
+  G4UIparameter* unitPrm = new G4UIparameter("unit", 's', true);
+  unitPrm->SetDefaultValue("mm");
+  fRegularCmd->SetParameter(unitPrm);
+  fRegularCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fRegularCmd->SetToBeBroadcasted(false);
+
+  fResetCmd = new G4UIcmdWithoutParameter("/SYP/geometry/reset", this);
+  fResetCmd->SetGuidance("Go back to the default 16-unit detector.");
+  fResetCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fResetCmd->SetToBeBroadcasted(false);
+
+  fParameterisedCmd = new G4UIcmdWithABool("/SYP/geometry/parameterised", this);
+  fParameterisedCmd->SetGuidance("Build the chambers as one parameterised"
+                                 " volume instead of one placement each.");
+  fParameterisedCmd->SetGuidance("The ribs are then cut out of the gas.");
+  fParameterisedCmd->SetParameterName("parameterised", true);
+  fParameterisedCmd->SetDefaultValue(true);
+  fParameterisedCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fParameterisedCmd->SetToBeBroadcasted(false);
+
+  fCheckOverlapsCmd = new G4UIcmdWithABool("/SYP/geometry/checkOverlaps", this);
+  fCheckOverlapsCmd->SetGuidance("Check the overlaps of each placement when"
+                                 " it is built or its solid replaced.");
+  fCheckOverlapsCmd->SetGuidance("Off by default: the whole geometry is"
+                                 " checked by exampleB1 --check-geometry.");
+  fCheckOverlapsCmd->SetParameterName("check", true);
+  fCheckOverlapsCmd->SetDefaultValue(true);
+  fCheckOverlapsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fCheckOverlapsCmd->SetToBeBroadcasted(false);
+
+  fRibThicknessCmd
+    = new G4UIcmdWithADoubleAndUnit("/SYP/geometry/ribThickness", this);
+  fRibThicknessCmd->SetGuidance("Thickness of the ribs between chambers.");
+  fRibThicknessCmd->SetGuidance("Only the rib solids are replaced.");
+  fRibThicknessCmd->SetParameterName("thickness", false);
+  fRibThicknessCmd->SetRange("thickness > 0.");
+  fRibThicknessCmd->SetUnitCategory("Length");
+  fRibThicknessCmd->SetDefaultUnit("mm");
+  fRibThicknessCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fRibThicknessCmd->SetToBeBroadcasted(false);
+
+  fSlicePitchCmd
+    = new G4UIcmdWithADoubleAndUnit("/SYP/geometry/slicePitch", this);
+  fSlicePitchCmd->SetGuidance("Distance between two electrode slices.");
+  fSlicePitchCmd->SetGuidance("The middle ES stays in place, the others move"
+                              " from it; only the slice solids are replaced.");
+  fSlicePitchCmd->SetParameterName("pitch", false);
+  fSlicePitchCmd->SetRange("pitch > 0.");
+  fSlicePitchCmd->SetUnitCategory("Length");
+  fSlicePitchCmd->SetDefaultUnit("mm");
+  fSlicePitchCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fSlicePitchCmd->SetToBeBroadcasted(false);
+
+  fWindowThicknessCmd
+    = new G4UIcmdWithADoubleAndUnit("/SYP/geometry/windowThickness", this);
+  fWindowThicknessCmd->SetGuidance("Thickness of the outer window plate.");
+  fWindowThicknessCmd->SetGuidance("Only the window solid is replaced.");
+  fWindowThicknessCmd->SetParameterName("thickness", false);
+  fWindowThicknessCmd->SetRange("thickness > 0.");
+  fWindowThicknessCmd->SetUnitCategory("Length");
+  fWindowThicknessCmd->SetDefaultUnit("mm");
+  fWindowThicknessCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fWindowThicknessCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPDetectorMessenger::~SYPDetectorMessenger()
+{
+  delete fLoadCmd;
+  delete fSaveCmd;
+  delete fRegularCmd;
+  delete fResetCmd;
+  delete fParameterisedCmd;
+  delete fCheckOverlapsCmd;
+  delete fRibThicknessCmd;
+  delete fSlicePitchCmd;
+  delete fWindowThicknessCmd;
+  delete fDirectory;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPDetectorMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if (command == fLoadCmd) {
+    fDetector->LoadParameters(newValue);
+  }
+
+  if (command == fSaveCmd) {
+    fDetector->GetParameters().Write(newValue);
+  }
+
+  if (command == fRegularCmd) {
+    G4int nofChambers;
+    G4double pitch;
+    G4String unit;
+    std::istringstream is(newValue);
+    is >> nofChambers >> pitch >> unit;
+    fDetector->SetRegularArray(nofChambers,
+                               pitch*G4UIcommand::ValueOf(unit));
+  }
+
+  if (command == fResetCmd) {
+    fDetector->SetParameters(SYPGeometryParameters());
+  }
+
+  if (command == fParameterisedCmd) {
+    fDetector->SetParameterisedChambers
+      (fParameterisedCmd->GetNewBoolValue(newValue));
+  }
+
+  if (command == fCheckOverlapsCmd) {
+    fDetector->SetCheckOverlaps
+      (fCheckOverlapsCmd->GetNewBoolValue(newValue));
+  }
+
+  if (command == fRibThicknessCmd) {
+    fDetector->SetRibThickness(fRibThicknessCmd->GetNewDoubleValue(newValue));
+  }
+
+  if (command == fSlicePitchCmd) {
+    fDetector->SetSlicePitch(fSlicePitchCmd->GetNewDoubleValue(newValue));
+  }
+
+  if (command == fWindowThicknessCmd) {
+    fDetector->SetWindowThickness
+      (fWindowThicknessCmd->GetNewDoubleValue(newValue));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -13,8 +13,13 @@
 SYPEventAction::SYPEventAction(SYPRunAction* runAction)
 : G4UserEventAction(),
   fRunAction(runAction),
-  fEdep(0.)
-{} 
+  fEdep(0.),
+  fHasTally(false),
+  fLine(-1),
+  fCrossedPlane(false)
+{
+  fTally.Reset();
+} 
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -26,14 +31,38 @@ SYPEventAction::~SYPEventAction()
 void SYPEventAction::BeginOfEventAction(const G4Event*)
 {    
   fEdep = 0.;
+  fCrossedPlane = false;
+  fPrimaryClones.clear();
+
+  // the tally block is cleared at the end of the previous event:
+  // in ray casting mode it is already filled by the primary generator,
+  // which is called before this action
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void SYPEventAction::EndOfEventAction(const G4Event*)
+void SYPEventAction::EndOfEventAction(const G4Event* event)
 {
   // accumulate statistics in run action
   //fRunAction->AddEdep(fEdep);
+
+  // the line is set by the primary generator of the next event, which
+  // is called before BeginOfEventAction(): it is cleared here, so that
+  // an event generated without a line is not counted in the last one
+  fLine = -1;
+
+  // most photons never reach a chamber: nothing to add then
+  if (!fHasTally) return;
+
+  // an aborted event is dropped, its tallies do not leak into the next
+  if (!event->IsAborted())
+  {
+    SYPRun* run = static_cast<SYPRun*>
+      (G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+    run->AddEvent(fTally);
+  }
+  fTally.Reset();
+  fHasTally = false;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
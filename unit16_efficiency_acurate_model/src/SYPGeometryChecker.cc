@@ -0,0 +1,173 @@
+
+/// \file SYPGeometryChecker.cc
+/// \brief Implementation of the SYPGeometryChecker class
+
+#include "SYPGeometryChecker.hh"
+
+#include "G4PhysicalVolumeStore.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Threading.hh"
+#include "G4AutoLock.hh"
+#include "G4Timer.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#ifdef G4MULTITHREADED
+#include "G4WorkerThread.hh"
+#endif
+
+#include <fstream>
+#include <thread>
+
+namespace
+{
+  G4Mutex nextVolumeMutex = G4MUTEX_INITIALIZER;
+
+  // volume names are plain identifiers, quotes and backslashes escaped
+  G4String JSONString(const G4String& text)
+  {
+    G4String quoted = "\"";
+    for (char c : text)
+    {
+      if (c == '"' || c == '\\') quoted += '\\';
+      quoted += c;
+    }
+    return quoted + "\"";
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPGeometryChecker::SYPGeometryChecker()
+: fResolution(10000),
+  fTolerance(0.),
+  fNofThreads(0),
+  fTime(0.),
+  fNext(0)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPGeometryChecker::~SYPGeometryChecker()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int SYPGeometryChecker::Check()
+{
+  // all the volumes placed in a mother
+  fResults.clear();
+  for (auto volume : *G4PhysicalVolumeStore::GetInstance())
+  {
+    if (volume->GetMotherLogical()) fResults.push_back({volume, false, 0.});
+  }
+  fNext = 0;
+
+  G4Timer timer;
+  timer.Start();
+
+#ifdef G4MULTITHREADED
+  G4int nofThreads = fNofThreads;
+  if (nofThreads <= 0) nofThreads = G4Threading::G4GetNumberOfCores();
+  if (nofThreads > (G4int)fResults.size()) nofThreads = fResults.size();
+
+  std::vector<std::thread> threads;
+  for (G4int i = 0; i < nofThreads; i++)
+  {
+    threads.push_back(std::thread(&SYPGeometryChecker::CheckVolumes, this, i));
+  }
+  for (auto& thread : threads) thread.join();
+#else
+  CheckVolumes(0);
+#endif
+
+  timer.Stop();
+  fTime = timer.GetRealElapsed();
+
+  G4int nofOverlaps = 0;
+  for (const auto& result : fResults)
+  {
+    if (result.overlaps) nofOverlaps++;
+  }
+  G4cout << " Overlap check of " << fResults.size() << " volumes with "
+         << fResolution << " points: " << nofOverlaps << " overlapping, "
+         << fTime << " s" << G4endl;
+
+  return nofOverlaps;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPGeometryChecker::CheckVolumes(G4int threadIndex)
+{
+#ifdef G4MULTITHREADED
+  // own copy of the transformations and solids, as in a worker thread,
+  // and own engine for the points on the surfaces
+  G4WorkerThread::BuildGeometryAndPhysicsVector();
+  CLHEP::MixMaxRng engine(threadIndex+1);
+  G4Random::setTheEngine(&engine);
+#else
+  (void)threadIndex;
+#endif
+
+  while (true)
+  {
+    G4int index;
+    {
+      G4AutoLock lock(&nextVolumeMutex);
+      index = fNext++;
+    }
+    if (index >= (G4int)fResults.size()) break;
+
+    Result& result = fResults[index];
+    G4Timer timer;
+    timer.Start();
+    result.overlaps
+      = result.volume->CheckOverlaps(fResolution, fTolerance, false, 1);
+    timer.Stop();
+    result.time = timer.GetRealElapsed();
+  }
+
+#ifdef G4MULTITHREADED
+  G4WorkerThread::DestroyGeometryAndPhysicsVector();
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SYPGeometryChecker::WriteReport(const G4String& fileName) const
+{
+  std::ofstream out(fileName);
+  if (!out) return false;
+
+  G4int nofOverlaps = 0;
+  for (const auto& result : fResults)
+  {
+    if (result.overlaps) nofOverlaps++;
+  }
+
+  out << "{\n"
+      << "  \"resolution\": " << fResolution << ",\n"
+      << "  \"tolerance_mm\": " << fTolerance/mm << ",\n"
+      << "  \"nofVolumes\": " << fResults.size() << ",\n"
+      << "  \"nofOverlaps\": " << nofOverlaps << ",\n"
+      << "  \"time_s\": " << fTime << ",\n"
+      << "  \"volumes\": [";
+  for (std::size_t i = 0; i < fResults.size(); i++)
+  {
+    const Result& result = fResults[i];
+    out << (i ? ",\n" : "\n")
+        << "    { \"name\": " << JSONString(result.volume->GetName())
+        << ", \"copyNo\": " << result.volume->GetCopyNo()
+        << ", \"mother\": "
+        << JSONString(result.volume->GetMotherLogical()->GetName())
+        << ", \"overlaps\": " << (result.overlaps ? "true" : "false")
+        << ", \"time_s\": " << result.time << " }";
+  }
+  out << "\n  ]\n}\n";
+
+  return out.good();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
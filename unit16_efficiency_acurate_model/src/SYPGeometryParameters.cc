@@ -0,0 +1,760 @@
+
+/// \file SYPGeometryParameters.cc
+/// \brief Implementation of the SYPGeometryParameters class
+
+#include "SYPGeometryParameters.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "G4Transform3D.hh"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <sys/stat.h>
+
+namespace
+{
+  typedef std::vector<G4TwoVector> Quad;
+
+  // smallest clearance between two electrode slices of the design scans
+  const G4double kMinSliceGap = 0.05*mm;
+
+  // clearance of the generated chambers and ribs from the gas edges,
+  // and shortest hole left between the window and the gas
+  const G4double kEnvelopeMargin = 0.1*mm;
+  const G4double kMinHoleLength = 1*mm;
+
+  // smallest clearance between a rib and a chamber of the design scans
+  const G4double kMinRibGap = 0.;
+
+  // index of a slice from its position, when it is created
+  G4int SliceIndex(const Quad& v, G4double slicePitch)
+  {
+    G4double centre = 0.25*(v[0].y() + v[1].y() + v[2].y() + v[3].y());
+    return G4int(std::floor(centre/slicePitch + 0.5));
+  }
+
+  // distance of a point to a convex quad, negative inside
+  G4double SignedDistance(const G4TwoVector& point, const Quad& quad)
+  {
+    G4double outside = DBL_MAX;
+    G4double inside = DBL_MAX;
+    G4int nofLeft = 0;
+    for (std::size_t i = 0; i < quad.size(); i++)
+    {
+      G4TwoVector a = quad[i];
+      G4TwoVector edge = quad[(i+1)%quad.size()] - a;
+      G4TwoVector d = point - a;
+      G4double length2 = edge.mag2();
+      G4double cross = edge.x()*d.y() - edge.y()*d.x();
+      if (cross > 0.) nofLeft++;
+      inside = std::min(inside, std::fabs(cross)/std::sqrt(length2));
+      G4double t = std::max(0., std::min(1., edge.dot(d)/length2));
+      outside = std::min(outside, (d - t*edge).mag());
+    }
+    G4bool isInside = (nofLeft == 0 || nofLeft == G4int(quad.size()));
+    return isInside ? -inside : outside;
+  }
+
+  // clearance between two convex quads, negative if they overlap
+  G4double Clearance(const Quad& a, const Quad& b)
+  {
+    G4double clearance = DBL_MAX;
+    for (const auto& vertex : a)
+    {
+      clearance = std::min(clearance, SignedDistance(vertex, b));
+    }
+    for (const auto& vertex : b)
+    {
+      clearance = std::min(clearance, SignedDistance(vertex, a));
+    }
+    return clearance;
+  }
+
+  Quad MakeQuad(G4double x0, G4double y0, G4double x1, G4double y1,
+                G4double x2, G4double y2, G4double x3, G4double y3)
+  {
+    Quad quad(4);
+    quad[0] = G4TwoVector(x0*mm, y0*mm);
+    quad[1] = G4TwoVector(x1*mm, y1*mm);
+    quad[2] = G4TwoVector(x2*mm, y2*mm);
+    quad[3] = G4TwoVector(x3*mm, y3*mm);
+    return quad;
+  }
+
+  // readers and writers of the values of one line, lengths in mm
+
+  G4bool ReadLength(std::istream& in, G4double& value)
+  {
+    in >> value;
+    value *= mm;
+    return !in.fail();
+  }
+
+  G4bool ReadQuad(std::istream& in, Quad& quad)
+  {
+    quad.resize(4);
+    for (G4int i = 0; i < 4; i++)
+    {
+      G4double x, y;
+      if (!ReadLength(in, x) || !ReadLength(in, y)) return false;
+      quad[i] = G4TwoVector(x, y);
+    }
+    return true;
+  }
+
+  template <class V> G4bool ReadVector(std::istream& in, V& vector)
+  {
+    G4double x, y, z;
+    if (!ReadLength(in, x) || !ReadLength(in, y) || !ReadLength(in, z))
+      return false;
+    vector = V(x, y, z);
+    return true;
+  }
+
+  void WriteQuad(std::ostream& out, const Quad& quad)
+  {
+    for (std::size_t i = 0; i < quad.size(); i++)
+    {
+      out << ' ' << quad[i].x()/mm << ' ' << quad[i].y()/mm;
+    }
+  }
+
+  template <class V> void WriteVector(std::ostream& out, const V& vector)
+  {
+    out << ' ' << vector.x()/mm << ' ' << vector.y()/mm
+        << ' ' << vector.z()/mm;
+  }
+
+  // cache of the parsed files
+  struct CachedFile
+  {
+    time_t modificationTime;
+    SYPGeometryParameters parameters;
+  };
+  std::map<G4String, CachedFile> fileCache;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPGeometryParameters::SYPGeometryParameters()
+{
+  worldSize = 10*m;
+
+  //
+  // Shell: window front to insulating back
+  // dx = 235.5*mm dy1 = 163*mm dy2 = 169.1166*mm(point to point)
+  //
+  shellHalfZ = 0.5*36*mm;
+  shellVertices = MakeQuad(0,81.5, 235,84.5583, 235,-84.5583, 0,-81.5);
+
+  //
+  // working gas area
+  // window back (precisely: according to the side window end gasket) to insulating front
+  // z_start = 14.3887*mm z_end = 210.5*mm
+  //
+  gasHalfZ = 0.5*16*mm;
+  gasVertices = MakeQuad(14.3887,79.5983, 220.5,82.3,
+                         220.5,-82.3, 14.3887,-79.5983);
+
+  // window and chamber, the chamber is divided in two units at y = 0
+  chamberHalfZ = 0.5*16*mm;
+  chamberAndWindowVertices = MakeQuad(-92.76855,9.49997, 92.76855,9.80003,
+                                      92.76855,-9.80003, -92.76855,-9.49997);
+  chamberVertices = MakeQuad(-92.751855,9.499997, 92.751855,9.800003,
+                             92.751855,-9.800003, -92.751855,-9.499997);
+
+  // electrode slices: 2 kinds, ES and EC,
+  // differ in height: 16*mm and 12*mm
+  // total 8, 6 complete, 2 half (the middle ES)
+  ESHalfZ = chamberHalfZ;
+  ECHalfZ = 0.5*12*mm;
+  slicePitch = 2.475*mm;
+
+  // index: slice pitches from the middle ES, negative on the right
+  struct { const char* name; G4int half; G4int copyNo; G4int index;
+           G4double v[8]; }
+  sliceTable[] = {
+    { "ES", 0, 30, 0,  { -92.75,0.25, 92.75,0.25, 92.75,0., -92.75,0. } },
+    { "ES", 1, 31, 0,  { -92.75,0., 92.75,0., 92.75,-0.25, -92.75,-0.25 } },
+    { "EC", 0, 0,  3,  { -92.7503,7.5625, 92.7496,7.7875,
+                         92.7502,7.2875, -92.7497,7.0625 } },
+    { "ES", 0, 1,  2,  { -92.7501,5.125, 92.7498,5.275,
+                         92.7502,4.775, -92.7498,4.625 } },
+    { "EC", 0, 2,  1,  { -92.7501,2.6875, 92.7499,2.7625,
+                         92.7501,2.2625, -92.7499,2.1875 } },
+    { "EC", 1, 4,  -1, { -92.7499,-2.1875, 92.7501,-2.2625,
+                         92.7499,-2.7625, -92.7501,-2.6875 } },
+    { "ES", 1, 5,  -2, { -92.7498,-4.625, 92.7502,-4.775,
+                         92.7498,-5.275, -92.7502,-5.125 } },
+    { "EC", 1, 6,  -3, { -92.7497,-7.0625, 92.7502,-7.2875,
+                         92.7496,-7.7875, -92.7503,-7.5625 } }
+  };
+  for (const auto& entry : sliceTable)
+  {
+    SYPElectrodeSlice slice;
+    slice.name = entry.name;
+    slice.half = entry.half;
+    slice.copyNo = entry.copyNo;
+    slice.index = entry.index;
+    slice.vertices = MakeQuad(entry.v[0], entry.v[1], entry.v[2], entry.v[3],
+                              entry.v[4], entry.v[5], entry.v[6], entry.v[7]);
+    slices.push_back(slice);
+  }
+
+  // place 8 chamberAndWindow in gas
+  // from ---- the original location
+  // middle ES location ---- left below, right below and right up
+  chamberReference[0] = G4Point3D(-92.75*mm, 0.25*mm,8*mm);
+  chamberReference[1] = G4Point3D(-92.75*mm,-0.25*mm,8*mm);
+  chamberReference[2] = G4Point3D( 92.75*mm,-0.25*mm,8*mm);
+
+  // to ---- the transformed location, copy number 0 on top
+  struct { G4int copyNo; G4double v[6]; } chamberTable[] = {
+    { 3, { 16.4996,10.2664,  16.5004,9.7664,   202,10.0791 } },
+    { 2, { 16.4987,30.2992,  16.5012,29.7992,  201.999,30.7373 } },
+    { 1, { 16.4978,50.332,   16.502,49.832,    201.995,51.3955 } },
+    { 0, { 16.4969,70.3724,  16.5028,69.8725,  201.99,72.0464 } },
+    { 4, { 16.5004,-9.7664,  16.4996,-10.2664, 201.999,-10.5791 } },
+    { 5, { 16.5012,-29.7992, 16.4987,-30.2992, 201.996,-31.237 } },
+    { 6, { 16.502,-49.832,   16.4978,-50.3319, 201.991,-51.8954 } },
+    { 7, { 16.5028,-69.8724, 16.4969,-70.3723, 201.984,-72.5463 } }
+  };
+  for (const auto& entry : chamberTable)
+  {
+    SYPChamberPlacement placement;
+    placement.copyNo = entry.copyNo;
+    for (G4int i = 0; i < 3; i++)
+    {
+      placement.to[i] = G4Point3D(entry.v[2*i]*mm, entry.v[2*i+1]*mm, 8*mm);
+    }
+    chambers.push_back(placement);
+  }
+
+  // 7 ribs
+  ribHalfZ = chamberHalfZ;
+  struct { G4int copyNo; G4double v[8]; } ribTable[] = {
+    { 3, { 15.25,0.5, 208.25,0.5, 208.25,-0.5, 15.25,-0.5 } },
+    { 2, { 15.2494,20.5286, 208.248,21.1793,
+           208.252,20.1793, 15.2528,19.5286 } },
+    { 1, { 15.249,40.5572, 208.245,41.8586,
+           208.251,40.8586, 15.2557,39.5572 } },
+    { 1, { 15.2502,60.5858, 208.24,62.5378,
+           208.25,61.5378, 15.2603,59.5859 } },
+    { 4, { 15.2494,-20.5286, 208.248,-21.1793,
+           208.252,-20.1793, 15.2528,-19.5286 } },
+    { 1, { 15.249,-40.5572, 208.245,-41.8586,
+           208.251,-40.8586, 15.2557,-39.5572 } },
+    { 6, { 15.2502,-60.5858, 208.24,-62.5378,
+           208.25,-61.5378, 15.2603,-59.5859 } }
+  };
+  for (const auto& entry : ribTable)
+  {
+    SYPRib rib;
+    rib.copyNo = entry.copyNo;
+    rib.vertices = MakeQuad(entry.v[0], entry.v[1], entry.v[2], entry.v[3],
+                            entry.v[4], entry.v[5], entry.v[6], entry.v[7]);
+    ribs.push_back(rib);
+  }
+
+  // window slice within the shell, outside the shell and
+  // the hole dug in the shell behind the window
+  windowHalfSize = G4ThreeVector(0.5*0.1*mm, 0.5*163*mm, 0.5*20*mm);
+  windowPosition = G4ThreeVector(0.05*mm, 0, 0);
+  windowOutHalfSize = G4ThreeVector(0.5*0.4*mm, 0.5*163*mm, 0.5*20*mm);
+  windowOutPosition = G4ThreeVector(-0.2*mm, 0, 0);
+  holeHalfSize = G4ThreeVector(0.5*13.8*mm, 0.5*160*mm, 0.5*10*mm);
+  holePosition = G4ThreeVector(7*mm, 0*mm, 0*mm);
+
+  // fan fitted to the placements above
+  fanFocusX = -5925.44*mm;
+  chamberCentreX = 109.25*mm;
+  ribStartX = 15.25*mm;
+  ribEndX = 208.25*mm;
+  ribThickness = 1*mm;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int SYPGeometryParameters::GetNofUnits() const
+{
+  G4int maxCopyNo = -1;
+  for (const auto& placement : chambers)
+  {
+    if (placement.copyNo > maxCopyNo) maxCopyNo = placement.copyNo;
+  }
+  return 2*(maxCopyNo+1);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SYPGeometryParameters::SetRegularArray(G4int nofChambers,
+                                              G4double pitch)
+{
+  if (nofChambers <= 0 || pitch <= 0.) return false;
+
+  // angle between two chambers, seen from the focus
+  G4double dTheta = pitch/(ribStartX - fanFocusX);
+
+  auto rotate = [this](const G4Point3D& point, G4double theta)
+  {
+    G4double x = point.x() - fanFocusX;
+    return G4Point3D(fanFocusX + std::cos(theta)*x - std::sin(theta)*point.y(),
+                     std::sin(theta)*x + std::cos(theta)*point.y(),
+                     point.z());
+  };
+
+  // corners of the chambers and ribs, for the envelope below
+  std::vector<G4TwoVector> corners;
+
+  // chambers, copy number 0 on top
+  std::vector<SYPChamberPlacement> newChambers;
+  for (G4int k = 0; k < nofChambers; k++)
+  {
+    G4double theta = (0.5*(nofChambers-1) - k)*dTheta;
+    SYPChamberPlacement placement;
+    placement.copyNo = k;
+    for (G4int i = 0; i < 3; i++)
+    {
+      G4Point3D centred = chamberReference[i] + G4Vector3D(chamberCentreX,0,0);
+      placement.to[i] = rotate(centred, theta);
+    }
+    newChambers.push_back(placement);
+
+    for (const auto& vertex : chamberAndWindowVertices)
+    {
+      G4Point3D corner = rotate(G4Point3D(vertex.x() + chamberCentreX,
+                                          vertex.y(), 0), theta);
+      corners.push_back(G4TwoVector(corner.x(), corner.y()));
+    }
+  }
+
+  // ribs between the chambers
+  std::vector<SYPRib> newRibs;
+  for (G4int j = 1; j < nofChambers; j++)
+  {
+    G4double theta = (0.5*nofChambers - j)*dTheta;
+    G4double halfT = 0.5*ribThickness;
+    G4Point3D ribCorners[4] = { G4Point3D(ribStartX, halfT,0),
+                                G4Point3D(ribEndX,   halfT,0),
+                                G4Point3D(ribEndX,  -halfT,0),
+                                G4Point3D(ribStartX,-halfT,0) };
+    SYPRib rib;
+    rib.copyNo = j-1;
+    for (G4int i = 0; i < 4; i++)
+    {
+      G4Point3D corner = rotate(ribCorners[i], theta);
+      rib.vertices.push_back(G4TwoVector(corner.x(), corner.y()));
+      corners.push_back(rib.vertices.back());
+    }
+    newRibs.push_back(rib);
+  }
+
+  // the gas encloses the corners with a margin: its front and back
+  // move out if needed, its sides keep the taper of the default gas
+  SYPGeometryParameters base;
+  const Quad& baseGas = base.gasVertices;
+  const Quad& baseShell = base.shellVertices;
+  G4double front = baseGas[0].x();
+  G4double back = baseGas[1].x();
+  G4double slope = (baseGas[1].y() - baseGas[0].y())/(back - front);
+  for (const auto& corner : corners)
+  {
+    front = std::min(front, corner.x() - kEnvelopeMargin);
+    back = std::max(back, corner.x() + kEnvelopeMargin);
+  }
+  G4double frontHalfY = 0.;
+  for (const auto& corner : corners)
+  {
+    frontHalfY = std::max(frontHalfY, std::fabs(corner.y()) + kEnvelopeMargin
+                                      - slope*(corner.x() - front));
+  }
+  G4double backHalfY = frontHalfY + slope*(back - front);
+
+  // the hole behind the window ends at the default distance from the
+  // gas: it must keep some length between the window and the gas
+  G4double holeStart = base.holePosition.x() - base.holeHalfSize.x();
+  G4double holeEnd = front - (baseGas[0].x()
+                              - base.holePosition.x() - base.holeHalfSize.x());
+  if (holeEnd - holeStart < kMinHoleLength) return false;
+
+  // the shell keeps its wall thicknesses around the gas, its front
+  // with the windows stays at x = 0
+  G4double shellBack = back + (baseShell[1].x() - baseGas[1].x());
+  G4double shellFrontHalfY = frontHalfY + (baseShell[0].y() - baseGas[0].y());
+  G4double shellBackHalfY = backHalfY + (baseShell[1].y() - baseGas[1].y());
+
+  chambers = newChambers;
+  ribs = newRibs;
+  gasVertices = MakeQuad(front/mm, frontHalfY/mm, back/mm, backHalfY/mm,
+                         back/mm, -backHalfY/mm, front/mm, -frontHalfY/mm);
+  shellVertices = MakeQuad(baseShell[0].x()/mm, shellFrontHalfY/mm,
+                           shellBack/mm, shellBackHalfY/mm,
+                           shellBack/mm, -shellBackHalfY/mm,
+                           baseShell[3].x()/mm, -shellFrontHalfY/mm);
+
+  // the windows cover the shell front, the hole keeps its wall
+  windowHalfSize.setY(shellFrontHalfY);
+  windowOutHalfSize.setY(shellFrontHalfY);
+  holeHalfSize.setX(0.5*(holeEnd - holeStart));
+  holeHalfSize.setY(shellFrontHalfY
+                    - (baseShell[0].y() - base.holeHalfSize.y()));
+  holePosition.setX(0.5*(holeStart + holeEnd));
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SYPGeometryParameters::SetRibThickness(G4double thickness)
+{
+  if (thickness <= 0.) return false;
+
+  // vertices 0,3 at the start and 1,2 at the end of the rib:
+  // move them symmetrically about the centre line
+  std::vector<SYPRib> newRibs(ribs);
+  for (auto& rib : newRibs)
+  {
+    Quad& v = rib.vertices;
+    for (G4int end = 0; end < 2; end++)
+    {
+      G4TwoVector& top = v[end];
+      G4TwoVector& bottom = v[3-end];
+      G4TwoVector centre = 0.5*(top + bottom);
+      G4TwoVector normal = (top - bottom).unit();
+      top = centre + 0.5*thickness*normal;
+      bottom = centre - 0.5*thickness*normal;
+    }
+  }
+
+  // the ribs must stay clear of the chambers, as placed in the gas
+  for (const auto& placement : chambers)
+  {
+    G4Transform3D transform(chamberReference[0], chamberReference[1],
+                            chamberReference[2], placement.to[0],
+                            placement.to[1], placement.to[2]);
+    Quad outline;
+    for (const auto& vertex : chamberAndWindowVertices)
+    {
+      G4Point3D corner = transform*G4Point3D(vertex.x(), vertex.y(),
+                                             chamberReference[0].z());
+      outline.push_back(G4TwoVector(corner.x(), corner.y()));
+    }
+    for (const auto& rib : newRibs)
+    {
+      if (Clearance(rib.vertices, outline) < kMinRibGap) return false;
+    }
+  }
+
+  ribs = newRibs;
+  ribThickness = thickness;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SYPGeometryParameters::SetSlicePitch(G4double pitch)
+{
+  // the slices must not touch: the pitch is at least the widest slice
+  // (the middle ES counts with its two halves) plus the clearance
+  G4double maxWidth = 0.;
+  for (G4int end = 0; end < 2; end++)
+  {
+    G4double middleWidth = 0.;
+    for (const auto& slice : slices)
+    {
+      G4double width = std::fabs(slice.vertices[end].y()
+                                 - slice.vertices[3-end].y());
+      if (slice.index == 0) middleWidth += width;
+      else maxWidth = std::max(maxWidth, width);
+    }
+    maxWidth = std::max(maxWidth, middleWidth);
+  }
+  if (pitch < maxWidth + kMinSliceGap) return false;
+
+  // the k-th slice from the middle moves by k*(pitch - slicePitch),
+  // the two halves of the middle ES stay at y = 0
+  std::vector<SYPElectrodeSlice> newSlices(slices);
+  for (auto& slice : newSlices)
+  {
+    Quad& v = slice.vertices;
+    G4double shift = slice.index*(pitch - slicePitch);
+    for (G4int end = 0; end < 2; end++)
+    {
+      v[end].setY(v[end].y() + shift);
+      v[3-end].setY(v[3-end].y() + shift);
+
+      // still within its own half-chamber at this end,
+      // y from 0 up to the chamber edge on the left, down on the right
+      G4double halfWidth = std::fabs(chamberVertices[end].y());
+      G4double low = (slice.half == 0) ? 0. : -halfWidth;
+      G4double high = (slice.half == 0) ? halfWidth : 0.;
+      for (G4double y : { v[end].y(), v[3-end].y() })
+      {
+        if (y < low || y > high) return false;
+      }
+    }
+  }
+
+  // and clear of the neighbouring slices at both ends
+  for (G4int end = 0; end < 2; end++)
+  {
+    std::vector<std::pair<G4double, const SYPElectrodeSlice*>> bottoms;
+    for (const auto& slice : newSlices)
+    {
+      bottoms.push_back(std::make_pair(
+        std::min(slice.vertices[end].y(), slice.vertices[3-end].y()), &slice));
+    }
+    std::sort(bottoms.begin(), bottoms.end());
+    for (std::size_t i = 1; i < bottoms.size(); i++)
+    {
+      const SYPElectrodeSlice* below = bottoms[i-1].second;
+      const SYPElectrodeSlice* above = bottoms[i].second;
+      G4double top = std::max(below->vertices[end].y(),
+                              below->vertices[3-end].y());
+      // the two halves of the middle ES touch at y = 0
+      if (below->index == above->index) continue;
+      if (top + kMinSliceGap > bottoms[i].first) return false;
+    }
+  }
+
+  slices = newSlices;
+  slicePitch = pitch;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SYPGeometryParameters::SetWindowThickness(G4double thickness)
+{
+  if (thickness <= 0.) return false;
+
+  // outer window plate, its back face on the shell front at x = 0
+  windowOutHalfSize.setX(0.5*thickness);
+  windowOutPosition.setX(-0.5*thickness);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SYPGeometryParameters::Read(const G4String& fileName)
+{
+  std::ifstream file(fileName);
+  if (!file)
+  {
+    G4ExceptionDescription description;
+    description << "Cannot open geometry file " << fileName;
+    G4Exception("SYPGeometryParameters::Read()", "SYPGeometry001",
+                JustWarning, description);
+    return false;
+  }
+
+  // the lists given in the file replace the default ones
+  G4bool newSlices = true, newChambers = true, newRibs = true;
+  // slices given without index, numbered with the pitch of the file
+  std::vector<std::size_t> unindexedSlices;
+
+  std::string line;
+  G4int lineNo = 0;
+  while (std::getline(file, line))
+  {
+    lineNo++;
+    std::size_t comment = line.find('#');
+    if (comment != std::string::npos) line.erase(comment);
+
+    std::istringstream in(line);
+    G4String keyword;
+    if (!(in >> keyword)) continue;
+
+    G4bool ok = true;
+    if (keyword == "world") ok = ReadLength(in, worldSize);
+    else if (keyword == "shell")
+      ok = ReadLength(in, shellHalfZ) && ReadQuad(in, shellVertices);
+    else if (keyword == "gas")
+      ok = ReadLength(in, gasHalfZ) && ReadQuad(in, gasVertices);
+    else if (keyword == "chamberHalfZ") ok = ReadLength(in, chamberHalfZ);
+    else if (keyword == "chamberAndWindow")
+      ok = ReadQuad(in, chamberAndWindowVertices);
+    else if (keyword == "chamber") ok = ReadQuad(in, chamberVertices);
+    else if (keyword == "ESHalfZ") ok = ReadLength(in, ESHalfZ);
+    else if (keyword == "ECHalfZ") ok = ReadLength(in, ECHalfZ);
+    else if (keyword == "slicePitch") ok = ReadLength(in, slicePitch);
+    else if (keyword == "slice")
+    {
+      if (newSlices) { slices.clear(); newSlices = false; }
+      SYPElectrodeSlice slice;
+      G4String half;
+      in >> slice.name >> half >> slice.copyNo;
+      slice.half = (half == "right") ? 1 : 0;
+      ok = (slice.name == "EC" || slice.name == "ES")
+        && (half == "left" || half == "right")
+        && ReadQuad(in, slice.vertices);
+      if (!(in >> slice.index))
+      {
+        unindexedSlices.push_back(slices.size());
+      }
+      slices.push_back(slice);
+    }
+    else if (keyword == "chamberReference")
+    {
+      ok = ReadVector(in, chamberReference[0])
+        && ReadVector(in, chamberReference[1])
+        && ReadVector(in, chamberReference[2]);
+    }
+    else if (keyword == "chamberPlacement")
+    {
+      if (newChambers) { chambers.clear(); newChambers = false; }
+      SYPChamberPlacement placement;
+      in >> placement.copyNo;
+      ok = ReadVector(in, placement.to[0]) && ReadVector(in, placement.to[1])
+        && ReadVector(in, placement.to[2]);
+      chambers.push_back(placement);
+    }
+    else if (keyword == "ribHalfZ") ok = ReadLength(in, ribHalfZ);
+    else if (keyword == "rib")
+    {
+      if (newRibs) { ribs.clear(); newRibs = false; }
+      SYPRib rib;
+      in >> rib.copyNo;
+      ok = ReadQuad(in, rib.vertices);
+      ribs.push_back(rib);
+    }
+    else if (keyword == "window")
+      ok = ReadVector(in, windowHalfSize) && ReadVector(in, windowPosition);
+    else if (keyword == "windowOut")
+      ok = ReadVector(in, windowOutHalfSize)
+        && ReadVector(in, windowOutPosition);
+    else if (keyword == "hole")
+      ok = ReadVector(in, holeHalfSize) && ReadVector(in, holePosition);
+    else if (keyword == "fan")
+    {
+      ok = ReadLength(in, fanFocusX) && ReadLength(in, chamberCentreX)
+        && ReadLength(in, ribStartX) && ReadLength(in, ribEndX)
+        && ReadLength(in, ribThickness);
+    }
+    else if (keyword == "regular")
+    {
+      G4int nofChambers = 0;
+      G4double pitch = 0.;
+      in >> nofChambers;
+      ok = ReadLength(in, pitch) && SetRegularArray(nofChambers, pitch);
+      if (ok) newChambers = newRibs = false;
+    }
+    else ok = false;
+
+    if (!ok)
+    {
+      G4ExceptionDescription description;
+      description << fileName << ":" << lineNo << ": cannot read \""
+                  << line << "\"";
+      G4Exception("SYPGeometryParameters::Read()", "SYPGeometry002",
+                  JustWarning, description);
+      return false;
+    }
+  }
+
+  for (auto i : unindexedSlices)
+  {
+    slices[i].index = SliceIndex(slices[i].vertices, slicePitch);
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SYPGeometryParameters::Write(const G4String& fileName) const
+{
+  std::ofstream out(fileName);
+  if (!out) return false;
+  out.precision(10);
+
+  out << "# Geometry of the chamber array, lengths in mm\n";
+  out << "world " << worldSize/mm << "\n";
+  out << "shell " << shellHalfZ/mm;
+  WriteQuad(out, shellVertices);
+  out << "\ngas " << gasHalfZ/mm;
+  WriteQuad(out, gasVertices);
+  out << "\nchamberHalfZ " << chamberHalfZ/mm;
+  out << "\nchamberAndWindow";
+  WriteQuad(out, chamberAndWindowVertices);
+  out << "\nchamber";
+  WriteQuad(out, chamberVertices);
+  out << "\nESHalfZ " << ESHalfZ/mm;
+  out << "\nECHalfZ " << ECHalfZ/mm;
+  out << "\nslicePitch " << slicePitch/mm << "\n";
+  out << "# slice name half copyNo x0 y0 x1 y1 x2 y2 x3 y3 [index]\n";
+  for (const auto& slice : slices)
+  {
+    out << "slice " << slice.name << ' '
+        << (slice.half == 0 ? "left" : "right") << ' ' << slice.copyNo;
+    WriteQuad(out, slice.vertices);
+    out << ' ' << slice.index << "\n";
+  }
+  out << "chamberReference";
+  for (G4int i = 0; i < 3; i++) WriteVector(out, chamberReference[i]);
+  out << "\n# chamberPlacement copyNo images of the 3 reference points\n";
+  for (const auto& placement : chambers)
+  {
+    out << "chamberPlacement " << placement.copyNo;
+    for (G4int i = 0; i < 3; i++) WriteVector(out, placement.to[i]);
+    out << "\n";
+  }
+  out << "ribHalfZ " << ribHalfZ/mm << "\n";
+  for (const auto& rib : ribs)
+  {
+    out << "rib " << rib.copyNo;
+    WriteQuad(out, rib.vertices);
+    out << "\n";
+  }
+  out << "# half sizes and position\n";
+  out << "window";
+  WriteVector(out, windowHalfSize);
+  WriteVector(out, windowPosition);
+  out << "\nwindowOut";
+  WriteVector(out, windowOutHalfSize);
+  WriteVector(out, windowOutPosition);
+  out << "\nhole";
+  WriteVector(out, holeHalfSize);
+  WriteVector(out, holePosition);
+  out << "\n# fan focusX chamberCentreX ribStartX ribEndX ribThickness\n";
+  out << "fan " << fanFocusX/mm << ' ' << chamberCentreX/mm << ' '
+      << ribStartX/mm << ' ' << ribEndX/mm << ' ' << ribThickness/mm << "\n";
+  out << "# regular nofChambers pitch: generate the chambers and ribs\n";
+
+  return out.good();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const SYPGeometryParameters* SYPGeometryParameters::Load
+  (const G4String& fileName)
+{
+  struct stat status;
+  if (stat(fileName.c_str(), &status) != 0)
+  {
+    G4ExceptionDescription description;
+    description << "Cannot find geometry file " << fileName;
+    G4Exception("SYPGeometryParameters::Load()", "SYPGeometry003",
+                JustWarning, description);
+    return 0;
+  }
+
+  auto cached = fileCache.find(fileName);
+  if (cached != fileCache.end()
+      && cached->second.modificationTime == status.st_mtime)
+  {
+    return &cached->second.parameters;
+  }
+
+  CachedFile entry;
+  entry.modificationTime = status.st_mtime;
+  if (!entry.parameters.Read(fileName)) return 0;
+
+  CachedFile& stored = fileCache[fileName];
+  stored = entry;
+  return &stored.parameters;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,204 @@
+/// \file SYPPhaseSpace.cc
+/// \brief Implementation of the phase-space file header and of the
+///        SYPPhaseSpaceWriter class
+
+#include "SYPPhaseSpace.hh"
+
+#include "G4GenericMessenger.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4AutoLock.hh"
+
+#include <cstring>
+
+namespace
+{
+  G4Mutex phaseSpaceMutex = G4MUTEX_INITIALIZER;
+
+  const char          kMagic[8] = { 'S','Y','P','P','H','S','P','\0' };
+  const std::uint32_t kVersion = 1;
+
+  // records buffered per thread before a write
+  const std::size_t kBufferSize = 4096;
+
+  static_assert(sizeof(SYPPhaseSpaceRecord) == 9*4,
+                "unexpected padding in SYPPhaseSpaceRecord");
+  static_assert(sizeof(SYPPhaseSpaceHeader) == 8 + 2*4 + 3*8,
+                "unexpected padding in SYPPhaseSpaceHeader");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPPhaseSpaceHeader::Init(G4double plane)
+{
+  std::memset(this, 0, sizeof(*this));
+  std::memcpy(magic, kMagic, sizeof(kMagic));
+  version = kVersion;
+  recordSize = sizeof(SYPPhaseSpaceRecord);
+  planeX = plane;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SYPPhaseSpaceHeader::IsValid() const
+{
+  return std::memcmp(magic, kMagic, sizeof(kMagic)) == 0
+      && version == kVersion
+      && recordSize == sizeof(SYPPhaseSpaceRecord);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPPhaseSpaceWriter* SYPPhaseSpaceWriter::fInstance = 0;
+G4ThreadLocal std::vector<SYPPhaseSpaceRecord>*
+  SYPPhaseSpaceWriter::fBuffer = 0;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPPhaseSpaceWriter* SYPPhaseSpaceWriter::Instance()
+{
+  if (!fInstance) fInstance = new SYPPhaseSpaceWriter;
+  return fInstance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPPhaseSpaceWriter::SYPPhaseSpaceWriter()
+: fMessenger(0),
+  fPlaneGap(1.*mm),
+  fPlaneX(0.),
+  fWriting(false),
+  fAppend(false),
+  fFile(0)
+{
+  fHeader.Init(0.);
+
+  fMessenger = new G4GenericMessenger(this, "/SYP/phaseSpace/",
+                                      "Phase space in front of the window");
+
+  G4GenericMessenger::Command& writeCmd
+    = fMessenger->DeclareMethod("write", &SYPPhaseSpaceWriter::SetFileName,
+        "Write the photons crossing the plane to a file (none: stop).");
+  writeCmd.SetParameterName("fileName", false);
+  writeCmd.command->SetToBeBroadcasted(false);
+
+  G4GenericMessenger::Command& gapCmd
+    = fMessenger->DeclareValueWithUnit("planeGap", "mm", fPlaneGap,
+        "Distance of the plane in front of the outer window.");
+  gapCmd.SetParameterName("planeGap", false);
+  gapCmd.SetRange("planeGap > 0.");
+  gapCmd.command->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPPhaseSpaceWriter::~SYPPhaseSpaceWriter()
+{
+  if (fFile) std::fclose(fFile);
+  delete fMessenger;
+  fInstance = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPPhaseSpaceWriter::SetFileName(const G4String& fileName)
+{
+  fFileName = (fileName == "none") ? G4String() : fileName;
+  fAppend = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPPhaseSpaceWriter::BeginOfRun(G4double windowFrontX)
+{
+  fWriting = false;
+  if (fFileName.empty()) return;
+
+  fPlaneX = windowFrontX - fPlaneGap;
+
+  if (fAppend)
+  {
+    // the header was read back or written by the previous run
+    fFile = std::fopen(fFileName.c_str(), "r+b");
+    if (fFile && fHeader.planeX != fPlaneX)
+    {
+      G4ExceptionDescription description;
+      description << "The plane of " << fFileName << " is at x = "
+                  << fHeader.planeX << " mm, not " << fPlaneX
+                  << " mm: the photons are not appended.";
+      G4Exception("SYPPhaseSpaceWriter::BeginOfRun()", "SYPPhaseSpace001",
+                  JustWarning, description);
+      std::fclose(fFile);
+      fFile = 0;
+      return;
+    }
+    if (fFile) std::fseek(fFile, 0, SEEK_END);
+  }
+  else
+  {
+    fFile = std::fopen(fFileName.c_str(), "w+b");
+    fHeader.Init(fPlaneX);
+    if (fFile) std::fwrite(&fHeader, sizeof(fHeader), 1, fFile);
+  }
+
+  if (!fFile)
+  {
+    G4ExceptionDescription description;
+    description << "Cannot open the phase-space file " << fFileName;
+    G4Exception("SYPPhaseSpaceWriter::BeginOfRun()", "SYPPhaseSpace002",
+                JustWarning, description);
+    return;
+  }
+  fAppend = true;
+  fWriting = true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPPhaseSpaceWriter::EndOfRun(G4int nofEvents)
+{
+  if (!fFile) return;
+
+  // the buffers of the workers were flushed at the end of their run
+  Flush();
+  fHeader.nofSourceEvents += nofEvents;
+  std::fseek(fFile, 0, SEEK_SET);
+  std::fwrite(&fHeader, sizeof(fHeader), 1, fFile);
+  std::fclose(fFile);
+  fFile = 0;
+  fWriting = false;
+
+  G4cout << " Phase space " << fFileName << ": " << fHeader.nofRecords
+         << " photons at x = " << fPlaneX << " mm from "
+         << fHeader.nofSourceEvents << " source photons" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPPhaseSpaceWriter::Write(const SYPPhaseSpaceRecord& record)
+{
+  if (!fBuffer)
+  {
+    fBuffer = new std::vector<SYPPhaseSpaceRecord>;
+    fBuffer->reserve(kBufferSize);
+  }
+  fBuffer->push_back(record);
+  if (fBuffer->size() >= kBufferSize) Flush();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPPhaseSpaceWriter::Flush()
+{
+  if (!fBuffer || fBuffer->empty()) return;
+
+  G4AutoLock lock(&phaseSpaceMutex);
+  if (fFile)
+  {
+    std::fwrite(fBuffer->data(), sizeof(SYPPhaseSpaceRecord),
+                fBuffer->size(), fFile);
+    fHeader.nofRecords += fBuffer->size();
+  }
+  fBuffer->clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
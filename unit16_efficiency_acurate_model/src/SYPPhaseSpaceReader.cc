@@ -0,0 +1,156 @@
+/// \file SYPPhaseSpaceReader.cc
+/// \brief Implementation of the SYPPhaseSpaceReader class
+
+#include "SYPPhaseSpaceReader.hh"
+
+#include "G4GenericMessenger.hh"
+
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPPhaseSpaceReader::SYPPhaseSpaceReader()
+: fMessenger(0),
+  fFirstRecord(0),
+  fNofPasses(1),
+  fMap(0),
+  fMapSize(0),
+  fRecords(0),
+  fNofRecords(0)
+{
+  fMessenger = new G4GenericMessenger(this, "/SYP/phaseSpace/",
+                                      "Phase space in front of the window");
+
+  G4GenericMessenger::Command& readCmd
+    = fMessenger->DeclareMethod("read", &SYPPhaseSpaceReader::Open,
+        "Replay the photons of a phase-space file (none: use the source).");
+  readCmd.SetParameterName("fileName", false);
+
+  G4GenericMessenger::Command& firstCmd
+    = fMessenger->DeclareProperty("firstRecord", fFirstRecord,
+        "Record replayed by the first event of the next runs.");
+  firstCmd.SetParameterName("firstRecord", false);
+  firstCmd.SetRange("firstRecord >= 0");
+
+  G4GenericMessenger::Command& skipCmd
+    = fMessenger->DeclareMethod("skipRecords",
+        &SYPPhaseSpaceReader::SkipRecords,
+        "Move the first record of the next runs on by nofRecords.");
+  skipCmd.SetParameterName("nofRecords", false);
+  skipCmd.SetRange("nofRecords >= 0");
+
+  G4GenericMessenger::Command& passesCmd
+    = fMessenger->DeclareProperty("passes", fNofPasses,
+        "Number of times the file may be replayed.");
+  passesCmd.SetParameterName("passes", false);
+  passesCmd.SetRange("passes > 0");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPPhaseSpaceReader::~SYPPhaseSpaceReader()
+{
+  Close();
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPPhaseSpaceReader::Close()
+{
+#ifndef _WIN32
+  if (fMap) munmap(fMap, fMapSize);
+#endif
+  fMap = 0;
+  fMapSize = 0;
+  std::vector<char>().swap(fData);
+  fRecords = 0;
+  fNofRecords = 0;
+  fFileName = "";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPPhaseSpaceReader::Open(const G4String& fileName)
+{
+  Close();
+  if (fileName == "none") return;
+
+  const char* data = 0;
+  std::size_t size = 0;
+#ifndef _WIN32
+  int descriptor = open(fileName.c_str(), O_RDONLY);
+  struct stat status;
+  if (descriptor >= 0 && fstat(descriptor, &status) == 0
+      && status.st_size > 0)
+  {
+    void* map = mmap(0, status.st_size, PROT_READ, MAP_SHARED, descriptor, 0);
+    if (map != MAP_FAILED)
+    {
+      fMap = map;
+      fMapSize = status.st_size;
+      data = static_cast<const char*>(map);
+      size = fMapSize;
+    }
+  }
+  if (descriptor >= 0) close(descriptor);
+#else
+  std::ifstream file(fileName, std::ios::binary);
+  fData.assign(std::istreambuf_iterator<char>(file),
+               std::istreambuf_iterator<char>());
+  data = fData.data();
+  size = fData.size();
+#endif
+
+  SYPPhaseSpaceHeader header;
+  G4bool ok = (data != 0 && size >= sizeof(header));
+  if (ok)
+  {
+    std::memcpy(&header, data, sizeof(header));
+    ok = header.IsValid();
+  }
+  if (!ok)
+  {
+    Close();
+    G4ExceptionDescription description;
+    description << fileName << " is not a phase-space file.";
+    G4Exception("SYPPhaseSpaceReader::Open()", "SYPPhaseSpace003",
+                FatalException, description);
+    return;
+  }
+
+  // the records actually there: the header of a file whose writing job
+  // was killed is not updated
+  fRecords = reinterpret_cast<const SYPPhaseSpaceRecord*>
+               (data + sizeof(header));
+  fNofRecords = (size - sizeof(header))/sizeof(SYPPhaseSpaceRecord);
+  fFileName = fileName;
+
+  G4cout << " Phase space " << fileName << ": " << fNofRecords
+         << " photons at x = " << header.planeX << " mm from "
+         << header.nofSourceEvents << " source photons" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const SYPPhaseSpaceRecord*
+SYPPhaseSpaceReader::GetRecord(G4int eventID) const
+{
+  if (fNofRecords == 0) return 0;
+
+  std::uint64_t index = std::uint64_t(fFirstRecord) + eventID;
+  if (index >= fNofRecords*fNofPasses) return 0;
+  return &fRecords[index % fNofRecords];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
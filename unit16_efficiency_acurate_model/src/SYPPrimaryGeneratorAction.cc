@@ -3,19 +3,40 @@
 /// \brief Implementation of the SYPPrimaryGeneratorAction class
 
 #include "SYPPrimaryGeneratorAction.hh"
+#include "SYPSeeding.hh"
+#include "SYPEventAction.hh"
+#include "SYPRayCaster.hh"
+#include "SYPSourceGeometry.hh"
+#include "SYPSourceSpectrum.hh"
+#include "SYPPhaseSpaceReader.hh"
+#include "SYPAirShortcut.hh"
 
 #include "G4GeneralParticleSource.hh"
 #include "G4ParticleGun.hh"
 #include "G4ParticleTable.hh"
 #include "G4ParticleDefinition.hh"
+#include "G4RunManager.hh"
+#include "G4Run.hh"
+#include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4GenericMessenger.hh"
 #include "G4SystemOfUnits.hh"
 #include "Randomize.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-SYPPrimaryGeneratorAction::SYPPrimaryGeneratorAction()
+SYPPrimaryGeneratorAction::SYPPrimaryGeneratorAction
+  (SYPEventAction* eventAction)
 : G4VUserPrimaryGeneratorAction(),
-  fParticleGun(0)
+  fParticleGun(0),
+  fEventAction(eventAction),
+  fMessenger(0),
+  fRayCast(false),
+  fRayCaster(0),
+  fSource(0),
+  fSpectrum(0),
+  fPhaseSpace(0),
+  fAirShortcut(0)
 {
   G4int n_particle = 1;
   fParticleGun  = new G4ParticleGun(n_particle);
@@ -25,6 +46,18 @@ SYPPrimaryGeneratorAction::SYPPrimaryGeneratorAction()
   fParticleGun->SetParticleDefinition(particle);
   fParticleGun->SetParticleEnergy(1.25*MeV);
   fParticleGun->SetParticlePosition(G4ThreeVector (-5874.17*mm,0,0*mm));
+
+  fSource = new SYPSourceGeometry;
+  fSpectrum = new SYPSourceSpectrum;
+  fPhaseSpace = new SYPPhaseSpaceReader;
+  fAirShortcut = new SYPAirShortcut;
+
+  fMessenger = new G4GenericMessenger(this, "/SYP/gun/", "Primary photons");
+  G4GenericMessenger::Command& rayCastCmd
+    = fMessenger->DeclareProperty("rayCast", fRayCast,
+        "Cast the primary photons through the geometry without physics.");
+  rayCastCmd.SetParameterName("rayCast", true);
+  rayCastCmd.SetDefaultValue("true");
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -32,6 +65,12 @@ SYPPrimaryGeneratorAction::SYPPrimaryGeneratorAction()
 SYPPrimaryGeneratorAction::~SYPPrimaryGeneratorAction()
 {
   delete fParticleGun;
+  delete fMessenger;
+  delete fRayCaster;
+  delete fSource;
+  delete fSpectrum;
+  delete fPhaseSpace;
+  delete fAirShortcut;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -41,19 +80,87 @@ void SYPPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
   // this function is called at the beginning of each event
   //
 
-  // G4double theta = 0.9166542564*deg; // atan(80/5000)
-  // G4double alpha = 0.05729576041*deg; // atan(5/5000)
-  // G4double alpha = 0.09167316899*deg; // atan(8/5000)
-  G4double theta = 0.7802598506*deg; // atan(80/5874.17)
-  G4double alpha = 0.07803076055*deg; // atan(8/5874.17)
-  G4double momentum_sizeY = 5874.17*tan(2*theta*(G4UniformRand()-0.5));
-  G4double momentum_sizeZ = 5874.17*tan(2*alpha*(G4UniformRand()-0.5));
-  G4double momentum_sizeX = 5874.17;
-  fParticleGun->SetParticleMomentumDirection(G4ThreeVector(momentum_sizeX,momentum_sizeY,momentum_sizeZ));
+  // seed this event from its own stream, before any random number is used
+  G4int runID = G4RunManager::GetRunManager()->GetCurrentRun()->GetRunID();
+  SYPSeeding::Instance()->SeedEvent(runID, anEvent->GetEventID());
+
+  G4double weight = 1.;
+  if (fPhaseSpace->IsOpen())
+  {
+    // photon replayed in front of the window, see SYPPhaseSpaceReader
+    const SYPPhaseSpaceRecord* record
+      = fPhaseSpace->GetRecord(anEvent->GetEventID());
+    if (!record)
+    {
+      G4ExceptionDescription description;
+      description << "All the passes over the phase-space file are used,"
+                  << " the run is stopped.";
+      G4Exception("SYPPrimaryGeneratorAction::GeneratePrimaries()",
+                  "SYPPhaseSpace004", JustWarning, description);
+      anEvent->SetEventAborted();
+      G4RunManager::GetRunManager()->AbortRun(true);
+      return;
+    }
+    fParticleGun->SetParticlePosition
+      (G4ThreeVector(record->position[0], record->position[1],
+                     record->position[2]));
+    fParticleGun->SetParticleMomentumDirection
+      (G4ThreeVector(record->direction[0], record->direction[1],
+                     record->direction[2]));
+    fParticleGun->SetParticleEnergy(record->energy);
+    weight = record->weight;
+    if (fEventAction) fEventAction->SetLine(record->line);
+  }
+  else
+  {
+    // fan beam from the source, see SYPSourceGeometry
+    G4ThreeVector position, direction;
+    fSource->Generate(position, direction, runID, anEvent->GetEventID());
+    fParticleGun->SetParticlePosition(position);
+    fParticleGun->SetParticleMomentumDirection(direction);
+
+    // energy from the source spectrum, the gun energy otherwise
+    if (!fSpectrum->IsMono())
+    {
+      G4int line = -1;
+      fParticleGun->SetParticleEnergy(fSpectrum->Sample(line));
+      if (fEventAction) fEventAction->SetLine(line);
+    }
+
+    // air gap crossed analytically, see SYPAirShortcut
+    if (fAirShortcut->IsActive())
+    {
+      weight = fAirShortcut->Transport
+        (position, direction, fParticleGun->GetParticleEnergy());
+      fParticleGun->SetParticlePosition(position);
+    }
+  }
 
+  // geometry only: the event has no primary to track
+  if (fRayCast && fEventAction)
+  {
+    if (!fRayCaster) fRayCaster = new SYPRayCaster;
+    SYPRayPath path;
+    fRayCaster->Cast(fParticleGun->GetParticlePosition(),
+                     fParticleGun->GetParticleMomentumDirection(), runID, path);
+    if (path.unit >= 0)
+    {
+      fEventAction->AddPhoton(path.unit, weight);
+      fEventAction->AddPath(path.unit, path.length);
+    }
+    return;
+  }
 
   fParticleGun->GeneratePrimaryVertex(anEvent);
+  if (weight != 1.) anEvent->GetPrimaryVertex()->SetWeight(weight);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+G4String SYPPrimaryGeneratorAction::GetSourceDescription() const
+{
+  if (fPhaseSpace->IsOpen()) return "phaseSpace " + fPhaseSpace->GetFileName();
+  return fSpectrum->GetDescription();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,123 @@
+
+/// \file SYPRayCaster.cc
+/// \brief Implementation of the SYPRayCaster class
+
+#include "SYPRayCaster.hh"
+#include "SYPDetectorConstruction.hh"
+
+#include "G4Navigator.hh"
+#include "G4TouchableHistory.hh"
+#include "G4TransportationManager.hh"
+#include "G4RunManager.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+
+namespace
+{
+  // guard against a ray stuck on a boundary
+  const G4int kMaxNofSteps = 10000;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPRayCaster::SYPRayCaster()
+: fNavigator(new G4Navigator),
+  fTouchable(new G4TouchableHistory),
+  fDetector(0),
+  fWorld(0),
+  fRunID(-1)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPRayCaster::~SYPRayCaster()
+{
+  delete fTouchable;
+  delete fNavigator;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SYPRayCaster::IsInChamber(G4int copyNo) const
+{
+  // the chamberAndWindow among the volumes holding the point
+  for (G4int depth = 0; depth <= fTouchable->GetHistoryDepth(); depth++)
+  {
+    G4VPhysicalVolume* volume = fTouchable->GetVolume(depth);
+    if (fDetector->GetVolumeRole(volume->GetLogicalVolume())
+        == kChamberAndWindowVolume)
+    {
+      return fTouchable->GetCopyNumber(depth) == copyNo;
+    }
+  }
+  return false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPRayCaster::Cast(const G4ThreeVector& position,
+                        const G4ThreeVector& direction, G4int runID,
+                        SYPRayPath& path)
+{
+  path.unit = -1;
+  for (G4int i = 0; i < kNofPathVolumes; i++) path.length[i] = 0.;
+
+  if (runID != fRunID)
+  {
+    fRunID = runID;
+    fDetector = static_cast<const SYPDetectorConstruction*>
+      (G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+    fWorld = G4TransportationManager::GetTransportationManager()
+      ->GetNavigatorForTracking()->GetWorldVolume();
+    fNavigator->SetWorldVolume(fWorld);
+  }
+
+  // copy number of the chamberAndWindow of the unit entered
+  G4int chamberCopyNo = -1;
+
+  G4ThreeVector point = position;
+  fNavigator->LocateGlobalPointAndUpdateTouchable(point, direction,
+                                                  fTouchable, false);
+
+  for (G4int n = 0; n < kMaxNofSteps; n++)
+  {
+    G4VPhysicalVolume* volume = fTouchable->GetVolume();
+    if (!volume) return;  // out of the world
+
+    G4double safety;
+    G4double step = fNavigator->ComputeStep(point, direction, kInfinity,
+                                            safety);
+    if (step == kInfinity) return;
+
+    const G4LogicalVolume* logical = volume->GetLogicalVolume();
+    G4int pathVolume = fDetector->GetPathVolume(logical);
+    if (pathVolume >= 0) path.length[pathVolume] += step;
+
+    point += step*direction;
+    fNavigator->SetGeometricallyLimitedStep();
+    fNavigator->LocateGlobalPointAndUpdateTouchable(point, direction,
+                                                    fTouchable, true);
+
+    G4VPhysicalVolume* next = fTouchable->GetVolume();
+    if (!next) return;
+
+    // through the unit, with its electrode slices, until the ray
+    // leaves the chamberAndWindow
+    if (path.unit >= 0)
+    {
+      if (!IsInChamber(chamberCopyNo)) return;
+      continue;
+    }
+
+    // entry in a chamber unit, as counted by the stepping action
+    if (fDetector->GetVolumeRole(logical) == kChamberAndWindowVolume
+        && fDetector->GetVolumeRole(next->GetLogicalVolume())
+           == kChamberVolume)
+    {
+      chamberCopyNo = fTouchable->GetCopyNumber(2);
+      path.unit = 2*chamberCopyNo + fTouchable->GetCopyNumber(0);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,305 @@
+
+/// \file SYPResultsFile.cc
+/// \brief Implementation of the SYPResultsFile class
+
+#include "SYPResultsFile.hh"
+
+#include "G4ios.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+  // file header, written once when the file is created
+  struct Header
+  {
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t recordSize;
+    std::uint32_t nofUnits;
+    std::uint32_t reserved;
+  };
+
+  const char          kMagic[8] = { 'S','Y','P','R','E','S','\0','\0' };
+  const std::uint32_t kVersion = 5;
+  const std::uint64_t kEndMark = 0x5359505245434f52ULL;  // "SYPRECOR"
+
+  static_assert(sizeof(Header) == 24, "unexpected padding in Header");
+  static_assert(sizeof(SYPRunRecord) ==
+                4*8 + 6*4 + SYPRunRecord::kTagLength
+                + 5*8*SYPRunRecord::kMaxNofUnits + 8,
+                "unexpected padding in SYPRunRecord");
+
+  long FileSize(std::FILE* file)
+  {
+    std::fseek(file, 0, SEEK_END);
+    return std::ftell(file);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPRunRecord::SetTag(const G4String& geometryTag)
+{
+  std::memset(tag, 0, kTagLength);
+  std::strncpy(tag, geometryTag.c_str(), kTagLength-1);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String SYPRunRecord::GetTag() const
+{
+  return G4String(tag, strnlen(tag, kTagLength));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPRunRecord::SetSource(const G4String& description)
+{
+  if (description == "mono" || description.empty())
+  {
+    source = 0;
+    return;
+  }
+
+  // 32-bit FNV-1a, 0 is kept for the mono gun
+  std::uint32_t hash = 2166136261u;
+  for (unsigned char c : description)
+  {
+    hash = (hash ^ c)*16777619u;
+  }
+  source = (hash == 0) ? 1 : hash;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPResultsFile::SYPResultsFile(const G4String& fileName)
+: fFileName(fileName),
+  fNofIndexed(0)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPResultsFile::~SYPResultsFile()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SYPResultsFile::CheckHeader(std::FILE* file) const
+{
+  Header header;
+  std::fseek(file, 0, SEEK_SET);
+  if (std::fread(&header, sizeof(Header), 1, file) != 1
+      || std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0
+      || header.version != kVersion
+      || header.recordSize != sizeof(SYPRunRecord)
+      || header.nofUnits != SYPRunRecord::kMaxNofUnits)
+  {
+    G4ExceptionDescription description;
+    description << fFileName << " is not a results file of this version.";
+    G4Exception("SYPResultsFile::CheckHeader()", "SYPResults001",
+                JustWarning, description);
+    return false;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SYPResultsFile::Append(const SYPRunRecord& record) const
+{
+  // "ab+" creates the file if needed and always writes at the end
+  std::FILE* file = std::fopen(fFileName.c_str(), "ab+");
+  if (!file)
+  {
+    G4ExceptionDescription description;
+    description << "Cannot open " << fFileName << " for writing.";
+    G4Exception("SYPResultsFile::Append()", "SYPResults002",
+                JustWarning, description);
+    return false;
+  }
+
+  long size = FileSize(file);
+  if (size == 0)
+  {
+    Header header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.recordSize = sizeof(SYPRunRecord);
+    header.nofUnits = SYPRunRecord::kMaxNofUnits;
+    header.reserved = 0;
+    std::fwrite(&header, sizeof(Header), 1, file);
+  }
+  else
+  {
+    if (!CheckHeader(file))
+    {
+      std::fclose(file);
+      return false;
+    }
+    // a write may not follow a read without a positioning call
+    std::fseek(file, 0, SEEK_END);
+
+    // realign after a record truncated by a killed job
+    long tail = (size - (long)sizeof(Header)) % (long)sizeof(SYPRunRecord);
+    if (tail != 0)
+    {
+      std::vector<char> padding(sizeof(SYPRunRecord) - tail, 0);
+      std::fwrite(padding.data(), 1, padding.size(), file);
+    }
+  }
+
+  SYPRunRecord completeRecord = record;
+  completeRecord.endMark = kEndMark;
+  G4bool written =
+    (std::fwrite(&completeRecord, sizeof(SYPRunRecord), 1, file) == 1);
+  written = (std::fclose(file) == 0) && written;
+  return written;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int SYPResultsFile::GetNofRecords() const
+{
+  std::FILE* file = std::fopen(fFileName.c_str(), "rb");
+  if (!file) return 0;
+
+  long size = FileSize(file);
+  std::fclose(file);
+  if (size < (long)sizeof(Header)) return 0;
+  return (size - sizeof(Header)) / sizeof(SYPRunRecord);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SYPResultsFile::ReadRecord(G4int index, SYPRunRecord& record) const
+{
+  std::FILE* file = std::fopen(fFileName.c_str(), "rb");
+  if (!file) return false;
+
+  G4bool ok = false;
+  if (CheckHeader(file))
+  {
+    long offset = sizeof(Header) + (long)index*sizeof(SYPRunRecord);
+    ok = index >= 0
+      && std::fseek(file, offset, SEEK_SET) == 0
+      && std::fread(&record, sizeof(SYPRunRecord), 1, file) == 1
+      && record.endMark == kEndMark;
+  }
+  std::fclose(file);
+  return ok;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPResultsFile::UpdateIndex() const
+{
+  G4int nofRecords = GetNofRecords();
+  if (nofRecords < fNofIndexed)
+  {
+    // the file was replaced
+    fIndex.clear();
+    fNofIndexed = 0;
+  }
+  if (nofRecords == fNofIndexed) return;
+
+  std::FILE* file = std::fopen(fFileName.c_str(), "rb");
+  if (!file) return;
+  if (!CheckHeader(file))
+  {
+    std::fclose(file);
+    return;
+  }
+
+  std::size_t nofSorted = fIndex.size();
+  long offset = sizeof(Header) + (long)fNofIndexed*sizeof(SYPRunRecord);
+  std::fseek(file, offset, SEEK_SET);
+  SYPRunRecord record;
+  for (G4int index = fNofIndexed; index < nofRecords; index++)
+  {
+    if (std::fread(&record, sizeof(SYPRunRecord), 1, file) != 1) break;
+    if (record.endMark != kEndMark)
+    {
+      // the last record may still be being written, it is read again
+      // by the next lookup; the others are truncated for good
+      if (index == nofRecords - 1) break;
+      fNofIndexed = index + 1;
+      continue;
+    }
+    fIndex.push_back(
+      IndexEntry(std::make_pair(record.GetTag(), record.energy), index));
+    fNofIndexed = index + 1;
+  }
+  std::fclose(file);
+
+  std::sort(fIndex.begin() + nofSorted, fIndex.end());
+  std::inplace_merge(fIndex.begin(), fIndex.begin() + nofSorted,
+                     fIndex.end());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<G4int> SYPResultsFile::Find(const G4String& tag, G4double energy,
+                                        G4double tolerance) const
+{
+  UpdateIndex();
+
+  // binary search of the first entry of the tag in the energy window
+  std::vector<G4int> indices;
+  IndexEntry first(std::make_pair(tag, energy - tolerance), -1);
+  for (auto entry = std::lower_bound(fIndex.begin(), fIndex.end(), first);
+       entry != fIndex.end()
+       && entry->first.first == tag
+       && entry->first.second <= energy + tolerance; ++entry)
+  {
+    indices.push_back(entry->second);
+  }
+  std::sort(indices.begin(), indices.end());
+  return indices;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SYPResultsFile::ExportCSV(const G4String& csvFileName) const
+{
+  std::FILE* file = std::fopen(fFileName.c_str(), "rb");
+  if (!file) return false;
+  if (!CheckHeader(file))
+  {
+    std::fclose(file);
+    return false;
+  }
+
+  // one line per run and chamber unit
+  std::ofstream csvFile(csvFileName);
+  csvFile.precision(10);
+  csvFile << "runID,tag,masterSeed,jobIndex,nofThreads,energy_MeV,source,"
+          << "nofEvents,time,realTime_s,unit,"
+          << "count,countPhoton,Edep_MeV,efficiency,efficiencyError\n";
+
+  SYPRunRecord record;
+  while (std::fread(&record, sizeof(SYPRunRecord), 1, file) == 1)
+  {
+    if (record.endMark != kEndMark) continue;
+    for (G4int i = 0; i < record.nofUnits; i++)
+    {
+      csvFile << record.runID << ',' << record.GetTag() << ','
+              << record.masterSeed << ',' << record.jobIndex << ','
+              << record.nofThreads << ',' << record.energy << ','
+              << record.source << ','
+              << record.nofEvents << ',' << (std::int64_t)record.time << ','
+              << record.realTime << ','
+              << i << ',' << record.count[i] << ',' << record.countPhoton[i]
+              << ',' << record.Edep[i] << ',' << record.efficiency[i] << ','
+              << record.efficiencyError[i] << '\n';
+    }
+  }
+  std::fclose(file);
+
+  return csvFile.good();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
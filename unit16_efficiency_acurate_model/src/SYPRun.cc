@@ -0,0 +1,143 @@
+
+/// \file SYPRun.cc
+/// \brief Implementation of the SYPRun class
+
+#include "SYPRun.hh"
+
+#include <algorithm>
+#include <cmath>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPTally::Reset()
+{
+  for (G4int k = 0; k < kNofKillCounters; k++) nofKilled[k] = 0.;
+  for (G4int i = 0; i < kMaxNofUnits; i++)
+  {
+    count[i] = 0.;
+    countPhoton[i] = 0.;
+    countSquared[i] = 0.;
+    countPhotonSquared[i] = 0.;
+    countCountPhoton[i] = 0.;
+    Edep[i] = 0.;
+    for (G4int j = 0; j < kNofPathVolumes; j++) pathLength[i][j] = 0.;
+    for (G4int j = 0; j < kNofLines; j++)
+    {
+      countLine[j][i] = 0.;
+      countPhotonLine[j][i] = 0.;
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPTally::Add(const SYPTally& other)
+{
+  for (G4int k = 0; k < kNofKillCounters; k++)
+  {
+    nofKilled[k] += other.nofKilled[k];
+  }
+  for (G4int i = 0; i < kMaxNofUnits; i++)
+  {
+    count[i] += other.count[i];
+    countPhoton[i] += other.countPhoton[i];
+    countSquared[i] += other.countSquared[i];
+    countPhotonSquared[i] += other.countPhotonSquared[i];
+    countCountPhoton[i] += other.countCountPhoton[i];
+    Edep[i] += other.Edep[i];
+    for (G4int j = 0; j < kNofPathVolumes; j++)
+    {
+      pathLength[i][j] += other.pathLength[i][j];
+    }
+    for (G4int j = 0; j < kNofLines; j++)
+    {
+      countLine[j][i] += other.countLine[j][i];
+      countPhotonLine[j][i] += other.countPhotonLine[j][i];
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPTally::AddEvent(const SYPTally& eventTally)
+{
+  Add(eventTally);
+  for (G4int i = 0; i < kMaxNofUnits; i++)
+  {
+    G4double c = eventTally.count[i];
+    G4double p = eventTally.countPhoton[i];
+    countSquared[i] += c*c;
+    countPhotonSquared[i] += p*p;
+    countCountPhoton[i] += c*p;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double SYPTally::GetEfficiency(G4int unit) const
+{
+  G4double nofPhotons = countPhoton[unit];
+  return (nofPhotons > 0.) ? count[unit]/nofPhotons : 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double SYPTally::GetEfficiencyError(G4int unit, G4double nofEvents) const
+{
+  G4double nofPhotons = countPhoton[unit];
+  if (nofPhotons <= 0. || nofEvents < 2.) return 0.;
+
+  // R = sum c / sum p over the events (c, p: event count and
+  // countPhoton), Var(R) = sum (c - R p)^2 / (sum p)^2 * N/(N-1).
+  // With weights 1 and one photon per event this is R(1-R)/sum p
+  G4double efficiency = GetEfficiency(unit);
+  G4double sum = countSquared[unit]
+               - 2.*efficiency*countCountPhoton[unit]
+               + efficiency*efficiency*countPhotonSquared[unit];
+  G4double variance = std::max(sum, 0.)/(nofPhotons*nofPhotons)
+                    * nofEvents/(nofEvents - 1.);
+  return std::sqrt(variance);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double SYPTally::GetLineEfficiency(G4int line, G4int unit) const
+{
+  G4double nofPhotons = countPhotonLine[line][unit];
+  return (nofPhotons > 0.) ? countLine[line][unit]/nofPhotons : 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPRun::SYPRun()
+: G4Run(),
+  fPrimaryEnergy(0.)
+{
+  fTally.Reset();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPRun::~SYPRun()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPRun::Merge(const G4Run* run)
+{
+  const SYPRun* localRun = static_cast<const SYPRun*>(run);
+  fTally.Add(localRun->fTally);
+  if (fPrimaryEnergy == 0.) fPrimaryEnergy = localRun->fPrimaryEnergy;
+  if (fSource.empty()) fSource = localRun->fSource;
+
+  G4Run::Merge(run);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPRun::AddEvent(const SYPTally& eventTally)
+{
+  fTally.AddEvent(eventTally);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
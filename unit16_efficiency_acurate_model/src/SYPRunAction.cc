@@ -5,7 +5,11 @@
 #include "SYPRunAction.hh"
 #include "SYPPrimaryGeneratorAction.hh"
 #include "SYPDetectorConstruction.hh"
-// #include "B1Run.hh"
+#include "SYPRun.hh"
+#include "SYPResultsFile.hh"
+#include "SYPSeeding.hh"
+#include "SYPConvergence.hh"
+#include "SYPPhaseSpace.hh"
 
 #include "G4RunManager.hh"
 #include "G4Run.hh"
@@ -15,33 +19,118 @@
 #include "G4UnitsTable.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4GeneralParticleSourceData.hh"
+#include "G4GenericMessenger.hh"
+#include "G4Threading.hh"
+
+#include <ctime>
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 SYPRunAction::SYPRunAction()
 : G4UserRunAction(),
-  fEdep(0.)
+  fEdep(0.),
+  fMessenger(0),
+  fConvergence(0),
+  fResultsFileName("SYPResults.dat"),
+  fGeometryTag("unit16")
 {
   // Register accumulable to the accumulable manager
   G4AccumulableManager* accumulableManager = G4AccumulableManager::Instance();
   accumulableManager->RegisterAccumulable(fEdep);
+
+  // the results are written by the master only
+  if (G4Threading::IsMasterThread()) DefineCommands();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 SYPRunAction::~SYPRunAction()
-{}
+{
+  delete fMessenger;
+  delete fConvergence;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPRunAction::DefineCommands()
+{
+  fMessenger = new G4GenericMessenger(this, "/SYP/results/",
+                                      "Run results store");
+
+  G4GenericMessenger::Command& fileNameCmd
+    = fMessenger->DeclareProperty("fileName", fResultsFileName,
+        "Binary file to which each run is appended.");
+  fileNameCmd.SetParameterName("fileName", false);
+  fileNameCmd.command->SetToBeBroadcasted(false);
+
+  G4GenericMessenger::Command& tagCmd
+    = fMessenger->DeclareProperty("tag", fGeometryTag,
+        "Geometry tag stored with each run (at most 31 characters).");
+  tagCmd.SetParameterName("tag", false);
+  tagCmd.command->SetToBeBroadcasted(false);
+
+  G4GenericMessenger::Command& exportCmd
+    = fMessenger->DeclareMethod("exportCSV", &SYPRunAction::ExportCSV,
+        "Export all runs of the results file to a CSV file.");
+  exportCmd.SetParameterName("csvFileName", false);
+  exportCmd.command->SetToBeBroadcasted(false);
+
+  // /SYP/run/ commands of the runs in batches
+  fConvergence = new SYPConvergence;
+
+  // /SYP/phaseSpace/ commands of the writer, shared by the threads
+  SYPPhaseSpaceWriter::Instance();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4Run* SYPRunAction::GenerateRun()
+{
+  SYPRun* run = new SYPRun;
+
+  // no primary generator on the master in multi-threaded mode,
+  // the energy is then taken from the worker runs when merging
+  const SYPPrimaryGeneratorAction* generatorAction
+    = static_cast<const SYPPrimaryGeneratorAction*>
+        (G4RunManager::GetRunManager()->GetUserPrimaryGeneratorAction());
+  if (generatorAction)
+  {
+    // the gun energy is used only by a mono-energetic source
+    G4String source = generatorAction->GetSourceDescription();
+    run->SetSource(source);
+    if (source == "mono")
+    {
+      run->SetPrimaryEnergy
+        (generatorAction->GetParticleGun()->GetParticleEnergy());
+    }
+  }
+  return run;
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 void SYPRunAction::BeginOfRunAction(const G4Run*)
 { 
-  // inform the runManager to save random number seed
-  G4RunManager::GetRunManager()->SetRandomNumberStore(false);
+  // the events are seeded by SYPSeeding; saving of the engine status
+  // is left to the /random/setSavingFlag command
 
   // reset accumulables to their initial values
   G4AccumulableManager* accumulableManager = G4AccumulableManager::Instance();
   accumulableManager->Reset();
+
+  // the phase-space file is opened before the workers start
+  if (IsMaster())
+  {
+    const SYPDetectorConstruction* detectorConstruction
+      = static_cast<const SYPDetectorConstruction*>
+          (G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+    const SYPGeometryParameters& parameters
+      = detectorConstruction->GetParameters();
+    SYPPhaseSpaceWriter::Instance()->BeginOfRun
+      (parameters.windowOutPosition.x() - parameters.windowOutHalfSize.x());
+
+    fTimer.Start();
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -49,11 +138,27 @@ void SYPRunAction::BeginOfRunAction(const G4Run*)
 void SYPRunAction::EndOfRunAction(const G4Run* run)
 {
   G4int nofEvents = run->GetNumberOfEvent();
+
+  // the workers end their run before the master
+  SYPPhaseSpaceWriter* phaseSpace = SYPPhaseSpaceWriter::Instance();
+  phaseSpace->Flush();
+  if (IsMaster()) phaseSpace->EndOfRun(nofEvents);
+
   if (nofEvents == 0) return;
 
   // Merge accumulables 
   G4AccumulableManager* accumulableManager = G4AccumulableManager::Instance();
   accumulableManager->Merge();
+
+  // the workers only contribute to the merged tallies,
+  // the efficiency table is computed and written by the master
+  if (!IsMaster()) return;
+  fTimer.Stop();
+
+  const SYPRun* sypRun = static_cast<const SYPRun*>(run);
+  const G4double* count = sypRun->GetTally().count;
+  const G4double* countPhoton = sypRun->GetTally().countPhoton;
+  G4int nofUnits = GetNofUnits();
 /*
   G4double edep  = fEdep.GetValue();
   G4double countSum, countPhotonSum;
@@ -70,18 +175,10 @@ void SYPRunAction::EndOfRunAction(const G4Run* run)
         
   // Print
   //  
-  if (IsMaster()) {
-    G4cout
-     << G4endl
-     << "--------------------End of Global Run-----------------------"
-     << G4endl;
-  }
-  else {
-    G4cout
-     << G4endl
-     << "--------------------End of Local Run------------------------"
-     << G4endl;
-  }
+  G4cout
+   << G4endl
+   << "--------------------End of Global Run-----------------------"
+   << G4endl;
 /*
   G4cout
      << " Number of photon is: "
@@ -95,11 +192,12 @@ void SYPRunAction::EndOfRunAction(const G4Run* run)
 */
      G4double sum=0;
      G4double sumphoton=0;
-     for( G4int i = 0; i < 16; i++ )
+     for( G4int i = 0; i < nofUnits; i++ )
      {
         //
         G4cout
-        <<" Detection Efficiency in Chamber[" << i << "] is: " << count[i] << " "<< countPhoton[i] << " " << (count[i])*100/(countPhoton[i]) << " % "
+        <<" Detection Efficiency in Chamber[" << i << "] is: " << count[i] << " "<< countPhoton[i] << " " << sypRun->GetEfficiency(i)*100
+        << " +- " << sypRun->GetEfficiencyError(i)*100 << " % "
         << G4endl;
 
         sum += count[i];
@@ -115,14 +213,20 @@ void SYPRunAction::EndOfRunAction(const G4Run* run)
 
      G4cout << "Global detection efficiency is " << sum*100/sumphoton << "%" <<G4endl;
 
-    std::fstream dataFile;
-    dataFile.open("DetectionEfficienvy.txt",std::ios::app|std::ios::out);
-    for( G4int i = 0; i < 16; i++)
-    {
-        dataFile << count[i]*100/countPhoton[i] << G4endl;
-    }
+     // efficiencies in the two Co-60 lines, for the energy calibration
+     PrintLineEfficiencies(sypRun, nofUnits);
 
+     // tracks killed by the stacking and stepping actions
+     PrintKilledTracks(sypRun);
 
+     // ray casting mode: mean unattenuated path on the way to each unit
+     PrintPathLengths(sypRun, nofUnits);
+
+    // Store the run with its metadata
+    WriteResults(sypRun, nofUnits);
+
+    // one more batch of a series run until convergence
+    if (fConvergence->IsActive()) fConvergence->AddBatch(sypRun, nofUnits);
 
 /*
      std::fstream dataFile;
@@ -140,12 +244,6 @@ void SYPRunAction::EndOfRunAction(const G4Run* run)
      << " Sensitivity is: "
      << 3648.4*edep/nofEvents << " pA/(cGy/h)"
      << G4endl */
-    std::fstream dataFile1;
-    dataFile1.open("sensitivity_read.txt",std::ios::app|std::ios::out);
-    for( G4int i = 0; i < 16; i++)
-    {
-        dataFile1 << Edep[i] << " MeV" << "    " << countPhoton[i] << "    "<< 3648.4*Edep[i]/countPhoton[i]  << G4endl;
-    }
      G4cout
      << "------------------------------------------------------------"
      << G4endl
@@ -154,11 +252,133 @@ void SYPRunAction::EndOfRunAction(const G4Run* run)
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void SYPRunAction::AddEdep( G4double edep, G4int copyno )
+void SYPRunAction::PrintPathLengths(const SYPRun* run, G4int nofUnits) const
 {
-  Edep[copyno] += edep;
+  const SYPTally& tally = run->GetTally();
+
+  G4double total = 0.;
+  for (G4int i = 0; i < nofUnits; i++)
+  {
+    for (G4int j = 0; j < kNofPathVolumes; j++) total += tally.pathLength[i][j];
+  }
+  if (total == 0.) return;  // photons tracked, not cast
+
+  G4cout << " Mean path of the photons entering a unit [mm]:"
+         << " shell window rib EC ES" << G4endl;
+  for (G4int i = 0; i < nofUnits; i++)
+  {
+    G4double nofPhotons = tally.countPhoton[i];
+    if (nofPhotons == 0.) continue;
+    G4cout << " Chamber[" << i << "]";
+    for (G4int j = 0; j < kNofPathVolumes; j++)
+    {
+      G4cout << " " << tally.pathLength[i][j]/nofPhotons/mm;
+    }
+    G4cout << G4endl;
+  }
 }
 
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPRunAction::PrintLineEfficiencies(const SYPRun* run,
+                                         G4int nofUnits) const
+{
+  const SYPTally& tally = run->GetTally();
+
+  G4double total = 0.;
+  for (G4int i = 0; i < nofUnits; i++)
+  {
+    for (G4int j = 0; j < SYPTally::kNofLines; j++)
+      total += tally.countPhotonLine[j][i];
+  }
+  if (total == 0.) return;  // no Co-60 source spectrum
+
+  G4cout << " Detection efficiency in the Co-60 lines [%]:"
+         << " 1.173 MeV 1.333 MeV ratio" << G4endl;
+  for (G4int i = 0; i < nofUnits; i++)
+  {
+    G4double efficiency1 = tally.GetLineEfficiency(0, i);
+    G4double efficiency2 = tally.GetLineEfficiency(1, i);
+    G4cout << " Chamber[" << i << "] " << efficiency1*100
+           << " " << efficiency2*100 << " "
+           << ((efficiency2 > 0.) ? efficiency1/efficiency2 : 0.) << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPRunAction::PrintKilledTracks(const SYPRun* run) const
+{
+  const G4double* nofKilled = run->GetTally().nofKilled;
+
+  G4cout << " Tracks killed at creation / at a step:" << G4endl
+         << "  eIoni e- in the metal        "
+         << nofKilled[kKilledStackMetalDelta] << " / "
+         << nofKilled[kKilledStepMetalDelta] << G4endl
+         << "  e- in the chambers           "
+         << nofKilled[kKilledStackChamberElectron] << " / "
+         << nofKilled[kKilledStepChamberElectron] << G4endl
+         << "  eBrem gammas in the chambers "
+         << nofKilled[kKilledStackChamberBrem] << " / "
+         << nofKilled[kKilledStepChamberBrem] << G4endl;
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+G4int SYPRunAction::GetNofUnits() const
+{
+  // the detector construction is shared by the master and the workers
+  const SYPDetectorConstruction* detectorConstruction
+    = static_cast<const SYPDetectorConstruction*>
+        (G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  return detectorConstruction->GetNofUnits();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPRunAction::WriteResults(const SYPRun* run, G4int nofUnits) const
+{
+  const SYPTally& tally = run->GetTally();
+
+  SYPRunRecord record = {};  // unused units stay zero
+  record.masterSeed = SYPSeeding::Instance()->GetMasterSeed();
+  record.jobIndex = SYPSeeding::Instance()->GetJobIndex();
+  record.nofThreads = G4Threading::GetNumberOfRunningWorkerThreads();
+  record.energy = run->GetPrimaryEnergy()/MeV;
+  record.time = (G4double) std::time(0);
+  record.realTime = fTimer.GetRealElapsed();
+  record.runID = run->GetRunID();
+  record.nofEvents = run->GetNumberOfEvent();
+  record.nofUnits = nofUnits;
+  record.SetSource(run->GetSource());
+  record.SetTag(fGeometryTag);
+  for (G4int i = 0; i < nofUnits; i++)
+  {
+    record.count[i] = tally.count[i];
+    record.countPhoton[i] = tally.countPhoton[i];
+    record.Edep[i] = tally.Edep[i]/MeV;
+    record.efficiency[i] = run->GetEfficiency(i);
+    record.efficiencyError[i] = run->GetEfficiencyError(i);
+  }
+
+  SYPResultsFile resultsFile(fResultsFileName);
+  if (resultsFile.Append(record))
+  {
+    G4cout << " Run " << record.runID << " stored in " << fResultsFileName
+           << " (record " << resultsFile.GetNofRecords()-1 << ")" << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPRunAction::ExportCSV(G4String csvFileName)
+{
+  SYPResultsFile resultsFile(fResultsFileName);
+  if (resultsFile.ExportCSV(csvFileName))
+  {
+    G4cout << " " << resultsFile.GetNofRecords() << " runs of "
+           << fResultsFileName << " exported to " << csvFileName << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
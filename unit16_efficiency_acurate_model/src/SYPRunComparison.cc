@@ -0,0 +1,118 @@
+/// \file SYPRunComparison.cc
+/// \brief Implementation of the SYPRunComparison class
+
+#include "SYPRunComparison.hh"
+#include "SYPResultsFile.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPRunComparison::SYPRunComparison(const G4String& fileName)
+: fResultsFile(new SYPResultsFile(fileName)),
+  fMaxPull(4.)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPRunComparison::~SYPRunComparison()
+{
+  delete fResultsFile;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int SYPRunComparison::Compare(const G4String& referenceTag,
+                                const G4String& tag) const
+{
+  // the last run of the tested tag ...
+  SYPRunRecord tested;
+  G4int index = fResultsFile->GetNofRecords() - 1;
+  for ( ; index >= 0; index--)
+  {
+    if (fResultsFile->ReadRecord(index, tested)
+        && tested.GetTag() == tag) break;
+  }
+
+  // ... and the last run of the reference with its energy and source
+  SYPRunRecord reference;
+  G4bool found = false;
+  std::vector<G4int> indices;
+  if (index >= 0) indices = fResultsFile->Find(referenceTag, tested.energy);
+  for (auto it = indices.rbegin(); it != indices.rend() && !found; ++it)
+  {
+    found = fResultsFile->ReadRecord(*it, reference)
+         && reference.source == tested.source;
+  }
+  if (!found)
+  {
+    G4ExceptionDescription description;
+    description << "No runs " << referenceTag << " and " << tag
+                << " with the same source in "
+                << fResultsFile->GetFileName() << ".";
+    G4Exception("SYPRunComparison::Compare()", "SYPCompare001",
+                JustWarning, description);
+    return -1;
+  }
+
+  G4cout << " Run " << tested.runID << " (" << tag << ", "
+         << tested.nofEvents << " events, " << tested.realTime << " s)"
+         << " compared with run " << reference.runID << " ("
+         << referenceTag << ", " << reference.nofEvents << " events, "
+         << reference.realTime << " s)";
+  if (tested.source == 0) G4cout << " at " << tested.energy << " MeV";
+  else                    G4cout << " with source " << tested.source;
+  G4cout << G4endl
+         << " Efficiency [%] " << referenceTag << " / " << tag
+         << ", pull, FOM gain:" << G4endl;
+
+  G4int nofUnits = std::min(tested.nofUnits, reference.nofUnits);
+  G4int nofOutliers = 0;
+  G4int nofTerms = 0;
+  G4double chi2 = 0.;
+  for (G4int i = 0; i < nofUnits; i++)
+  {
+    G4double error2 = reference.efficiencyError[i]*reference.efficiencyError[i]
+                    + tested.efficiencyError[i]*tested.efficiencyError[i];
+    G4double pull = 0.;
+    if (error2 > 0.)
+    {
+      pull = (tested.efficiency[i] - reference.efficiency[i])
+           / std::sqrt(error2);
+      chi2 += pull*pull;
+      nofTerms++;
+    }
+    if (std::fabs(pull) > fMaxPull) nofOutliers++;
+
+    // FOM ratio = (relErrRef^2 * timeRef) / (relErr^2 * time)
+    G4double referenceCost = reference.efficiencyError[i]
+                           * reference.efficiencyError[i]*reference.realTime;
+    G4double testedCost = tested.efficiencyError[i]
+                        * tested.efficiencyError[i]*tested.realTime;
+    G4double gain = 0.;
+    if (tested.efficiency[i] > 0. && reference.efficiency[i] > 0.
+        && testedCost > 0.)
+    {
+      gain = (referenceCost/(reference.efficiency[i]*reference.efficiency[i]))
+           / (testedCost/(tested.efficiency[i]*tested.efficiency[i]));
+    }
+
+    G4cout << " Chamber[" << i << "] "
+           << reference.efficiency[i]*100 << " +- "
+           << reference.efficiencyError[i]*100 << " / "
+           << tested.efficiency[i]*100 << " +- "
+           << tested.efficiencyError[i]*100 << "  " << pull << "  ";
+    if (gain > 0.) G4cout << gain;
+    else           G4cout << "-";
+    G4cout << G4endl;
+  }
+
+  G4cout << " chi2/ndf = " << chi2 << "/" << nofTerms << ", "
+         << nofOutliers << " units with |pull| > " << fMaxPull << G4endl;
+
+  return nofOutliers;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
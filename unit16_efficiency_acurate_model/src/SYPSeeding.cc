@@ -0,0 +1,149 @@
+
+/// \file SYPSeeding.cc
+/// \brief Implementation of the SYPSeeding class
+
+#include "SYPSeeding.hh"
+
+#include "G4GenericMessenger.hh"
+#include "Randomize.hh"
+#include "CLHEP/Random/MixMaxRng.h"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPSeeding* SYPSeeding::fInstance = 0;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPSeeding* SYPSeeding::Instance()
+{
+  if (!fInstance) fInstance = new SYPSeeding;
+  return fInstance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPSeeding::SYPSeeding()
+: fMessenger(0),
+  fMasterSeed(0),
+  fJobIndex(0),
+  fSeedEachEvent(true),
+  fReplayRunID(-1),
+  fReplayEventID(-1)
+{
+  DefineCommands();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPSeeding::~SYPSeeding()
+{
+  delete fMessenger;
+  fInstance = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPSeeding::DefineCommands()
+{
+  fMessenger = new G4GenericMessenger(this, "/SYP/random/",
+                                      "Seeding of the random engines");
+
+  G4GenericMessenger::Command& masterSeedCmd
+    = fMessenger->DeclareMethod("masterSeed", &SYPSeeding::SetMasterSeed,
+        "Re-seed the master engine with a new master seed.");
+  masterSeedCmd.SetParameterName("masterSeed", false);
+  masterSeedCmd.command->SetToBeBroadcasted(false);
+
+  G4GenericMessenger::Command& jobIndexCmd
+    = fMessenger->DeclareMethod("jobIndex", &SYPSeeding::SetJobIndex,
+        "Re-seed the master engine for a new job index.");
+  jobIndexCmd.SetParameterName("jobIndex", false);
+  jobIndexCmd.command->SetToBeBroadcasted(false);
+
+  G4GenericMessenger::Command& seedEachEventCmd
+    = fMessenger->DeclareProperty("seedEachEvent", fSeedEachEvent,
+        "Seed every event from (master seed, job, run, event).");
+  seedEachEventCmd.SetParameterName("flag", false);
+  seedEachEventCmd.command->SetToBeBroadcasted(false);
+
+  G4GenericMessenger::Command& replayRunCmd
+    = fMessenger->DeclareProperty("replayRun", fReplayRunID,
+        "Run of the events to replay, negative to switch off.");
+  replayRunCmd.SetParameterName("runID", false);
+  replayRunCmd.command->SetToBeBroadcasted(false);
+
+  G4GenericMessenger::Command& replayEventCmd
+    = fMessenger->DeclareProperty("replayEvent", fReplayEventID,
+        "First event to replay, negative to switch off.");
+  replayEventCmd.SetParameterName("eventID", false);
+  replayEventCmd.command->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPSeeding::SetSeeds(G4long masterSeed, G4int jobIndex)
+{
+  fMasterSeed = masterSeed & 0xffffffffL;
+  fJobIndex = jobIndex;
+
+  // MixMax is the only engine seeded here, so the streams are disjoint
+  if (!dynamic_cast<CLHEP::MixMaxRng*>(G4Random::getTheEngine()))
+  {
+    G4Random::setTheEngine(new CLHEP::MixMaxRng);
+  }
+
+  // the engine keeps a pointer to the seeds: they must outlive the call
+  static long seeds[4];
+  seeds[0] = fMasterSeed;
+  seeds[1] = fJobIndex & 0xffffffffL;
+  seeds[2] = 0;
+  seeds[3] = 0;
+  G4Random::getTheEngine()->setSeeds(seeds, 4);
+
+  G4cout << " Random engine MixMax, master seed " << fMasterSeed
+         << ", job index " << fJobIndex << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPSeeding::GetEventStream(G4int& runID, G4int& eventID) const
+{
+  if (fReplayRunID >= 0 && fReplayEventID >= 0)
+  {
+    runID = fReplayRunID;
+    eventID += fReplayEventID;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPSeeding::SeedEvent(G4int runID, G4int eventID) const
+{
+  if (!IsSeedingEachEvent()) return;
+
+  GetEventStream(runID, eventID);
+
+  // runID+1 keeps the event streams apart from the master stream
+  static G4ThreadLocal long seeds[4];
+  seeds[0] = fMasterSeed;
+  seeds[1] = fJobIndex & 0xffffffffL;
+  seeds[2] = runID + 1;
+  seeds[3] = eventID;
+  G4Random::getTheEngine()->setSeeds(seeds, 4);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPSeeding::SeedBatch(CLHEP::HepRandomEngine* engine, G4int runID,
+                           G4int batchIndex) const
+{
+  // the top bit keeps the batch streams apart from the event streams
+  static G4ThreadLocal long seeds[4];
+  seeds[0] = fMasterSeed;
+  seeds[1] = fJobIndex & 0xffffffffL;
+  seeds[2] = ((runID + 1) & 0x7fffffffL) | 0x80000000L;
+  seeds[3] = batchIndex;
+  engine->setSeeds(seeds, 4);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,231 @@
+
+/// \file SYPSourceGeometry.cc
+/// \brief Implementation of the SYPSourceGeometry class
+
+#include "SYPSourceGeometry.hh"
+#include "SYPSeeding.hh"
+
+#include "G4GenericMessenger.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+#include "CLHEP/Random/MixMaxRng.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+  // intervals of the tangent tables; tan is smooth over the few degrees
+  // of the fan, the linear interpolation error is below 1e-9
+  const G4int kTableSize = 4096;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPSourceGeometry::SYPSourceGeometry()
+: fMessenger(0),
+  fDistance(5874.17*mm),
+  fHalfAngleY(std::atan(80./5874.17)),
+  fHalfAngleZ(std::atan(8./5874.17)),
+  fSpotRadius(0.),
+  fBatchSize(256),
+  fTablesValid(false),
+  fNext(0),
+  fBatchEngine(new CLHEP::MixMaxRng),
+  fBatchRunID(-1),
+  fBatchIndex(-1)
+{
+  fMessenger = new G4GenericMessenger(this, "/SYP/source/",
+                                      "Geometry of the photon source");
+
+  G4GenericMessenger::Command& distanceCmd
+    = fMessenger->DeclareMethodWithUnit("distance", "mm",
+        &SYPSourceGeometry::SetDistance,
+        "Distance of the source plane from the front of the shell.");
+  distanceCmd.SetParameterName("distance", false);
+  distanceCmd.SetRange("distance > 0.");
+
+  G4GenericMessenger::Command& halfAngleYCmd
+    = fMessenger->DeclareMethodWithUnit("halfAngleY", "deg",
+        &SYPSourceGeometry::SetHalfAngleY,
+        "Half angle of the fan across the chambers (y).");
+  halfAngleYCmd.SetParameterName("halfAngle", false);
+  halfAngleYCmd.SetRange("halfAngle >= 0.");
+
+  G4GenericMessenger::Command& halfAngleZCmd
+    = fMessenger->DeclareMethodWithUnit("halfAngleZ", "deg",
+        &SYPSourceGeometry::SetHalfAngleZ,
+        "Half angle of the fan along the chambers height (z).");
+  halfAngleZCmd.SetParameterName("halfAngle", false);
+  halfAngleZCmd.SetRange("halfAngle >= 0.");
+
+  G4GenericMessenger::Command& spotCmd
+    = fMessenger->DeclareMethodWithUnit("spotRadius", "mm",
+        &SYPSourceGeometry::SetSpotRadius,
+        "Radius of the source spot, 0 for a point source.");
+  spotCmd.SetParameterName("radius", false);
+  spotCmd.SetRange("radius >= 0.");
+
+  G4GenericMessenger::Command& batchCmd
+    = fMessenger->DeclareMethod("batchSize", &SYPSourceGeometry::SetBatchSize,
+        "Photons generated ahead of time (1: one per event).");
+  batchCmd.SetParameterName("batchSize", false);
+  batchCmd.SetRange("batchSize > 0");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPSourceGeometry::~SYPSourceGeometry()
+{
+  delete fMessenger;
+  delete fBatchEngine;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPSourceGeometry::SetDistance(G4double distance)
+{
+  fDistance = distance;
+  fTablesValid = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPSourceGeometry::SetHalfAngleY(G4double halfAngle)
+{
+  fHalfAngleY = halfAngle;
+  fTablesValid = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPSourceGeometry::SetHalfAngleZ(G4double halfAngle)
+{
+  fHalfAngleZ = halfAngle;
+  fTablesValid = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPSourceGeometry::SetSpotRadius(G4double radius)
+{
+  fSpotRadius = radius;
+  fTablesValid = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPSourceGeometry::SetBatchSize(G4int batchSize)
+{
+  fBatchSize = batchSize;
+
+  // the photons already generated belong to batches of the old size
+  fPositions.clear();
+  fDirections.clear();
+  fNext = 0;
+  fBatchIndex = -1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPSourceGeometry::BuildTables()
+{
+  fTanY.resize(kTableSize+1);
+  fTanZ.resize(kTableSize+1);
+  for (G4int i = 0; i <= kTableSize; i++)
+  {
+    G4double u = 2.*i/kTableSize - 1.;
+    fTanY[i] = std::tan(u*fHalfAngleY);
+    fTanZ[i] = std::tan(u*fHalfAngleZ);
+  }
+
+  // the photons already generated used the old parameters
+  fPositions.clear();
+  fDirections.clear();
+  fNext = 0;
+  fBatchIndex = -1;
+  fTablesValid = true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double SYPSourceGeometry::Interpolate(const std::vector<G4double>& table,
+                                        G4double u) const
+{
+  G4double x = u*kTableSize;
+  G4int i = std::min(G4int(x), kTableSize-1);
+  G4double f = x - i;
+  return table[i] + f*(table[i+1] - table[i]);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPSourceGeometry::FillBatch(G4int size,
+                                  CLHEP::HepRandomEngine* engine)
+{
+  fPositions.resize(size);
+  fDirections.resize(size);
+
+  // all the random numbers of the batch in one call, into a buffer
+  // kept from one batch to the next
+  G4int nofRandoms = (fSpotRadius > 0.) ? 4 : 2;
+  fRandoms.resize(size*nofRandoms);
+  engine->flatArray(fRandoms.size(), fRandoms.data());
+
+  for (G4int k = 0; k < size; k++)
+  {
+    const G4double* r = &fRandoms[k*nofRandoms];
+
+    G4double y = 0., z = 0.;
+    if (fSpotRadius > 0.)
+    {
+      // uniform in the disk
+      G4double radius = fSpotRadius*std::sqrt(r[2]);
+      G4double phi = twopi*r[3];
+      y = radius*std::cos(phi);
+      z = radius*std::sin(phi);
+    }
+    fPositions[k] = G4ThreeVector(-fDistance, y, z);
+
+    G4ThreeVector direction(1., Interpolate(fTanY, r[0]),
+                            Interpolate(fTanZ, r[1]));
+    fDirections[k] = direction.unit();
+  }
+  fNext = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPSourceGeometry::Generate(G4ThreeVector& position,
+                                 G4ThreeVector& direction,
+                                 G4int runID, G4int eventID)
+{
+  if (!fTablesValid) BuildTables();
+
+  const SYPSeeding* seeding = SYPSeeding::Instance();
+  if (seeding->IsSeedingEachEvent())
+  {
+    // the photon at the place of the event in its batch
+    seeding->GetEventStream(runID, eventID);
+    G4int batchIndex = eventID/fBatchSize;
+    if (batchIndex != fBatchIndex || runID != fBatchRunID)
+    {
+      seeding->SeedBatch(fBatchEngine, runID, batchIndex);
+      FillBatch(fBatchSize, fBatchEngine);
+      fBatchRunID = runID;
+      fBatchIndex = batchIndex;
+    }
+    fNext = eventID - batchIndex*fBatchSize;
+  }
+  else if (fBatchIndex >= 0 || fNext >= fPositions.size())
+  {
+    FillBatch(fBatchSize, G4Random::getTheEngine());
+    fBatchIndex = -1;
+  }
+
+  position = fPositions[fNext];
+  direction = fDirections[fNext];
+  fNext++;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
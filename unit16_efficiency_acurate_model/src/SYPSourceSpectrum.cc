@@ -0,0 +1,164 @@
+
+/// \file SYPSourceSpectrum.cc
+/// \brief Implementation of the SYPSourceSpectrum class
+
+#include "SYPSourceSpectrum.hh"
+
+#include "G4GenericMessenger.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+  // Co-60 gamma lines and emission probabilities (NNDC)
+  const G4double kCo60Energy[SYPSourceSpectrum::kNofLines]
+    = { 1.173228*MeV, 1.332492*MeV };
+  const G4double kCo60Intensity[SYPSourceSpectrum::kNofLines]
+    = { 0.9985, 0.999826 };
+
+  // Co-60 line of a discrete energy, -1 if none
+  G4int Co60Line(G4double energy)
+  {
+    for (G4int i = 0; i < SYPSourceSpectrum::kNofLines; i++)
+    {
+      if (std::fabs(energy - kCo60Energy[i]) < 0.5*keV) return i;
+    }
+    return -1;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPSourceSpectrum::SYPSourceSpectrum()
+: fMessenger(0),
+  fMode("mono"),
+  fValid(false)
+{
+  fMessenger = new G4GenericMessenger(this, "/SYP/source/",
+                                      "Geometry of the photon source");
+
+  G4GenericMessenger::Command& spectrumCmd
+    = fMessenger->DeclareMethod("spectrum", &SYPSourceSpectrum::SetMode,
+        "Energy spectrum: mono (/gun/energy), co60 or file.");
+  spectrumCmd.SetParameterName("spectrum", false);
+  spectrumCmd.SetCandidates("mono co60 file");
+
+  G4GenericMessenger::Command& fileCmd
+    = fMessenger->DeclareMethod("spectrumFile",
+        &SYPSourceSpectrum::SetFileName,
+        "Spectrum table, lines of \"Elow Ehigh weight\" in MeV.");
+  fileCmd.SetParameterName("fileName", false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPSourceSpectrum::~SYPSourceSpectrum()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPSourceSpectrum::SetMode(const G4String& mode)
+{
+  fMode = mode;
+  fValid = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SYPSourceSpectrum::SetFileName(const G4String& fileName)
+{
+  fFileName = fileName;
+  fValid = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String SYPSourceSpectrum::GetDescription() const
+{
+  if (fMode == "file") return fMode + " " + fFileName;
+  return fMode;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SYPSourceSpectrum::ReadFile(const G4String& fileName)
+{
+  std::ifstream file(fileName);
+  if (!file) return false;
+
+  std::vector<G4double> weights;
+  std::string line;
+  while (std::getline(file, line))
+  {
+    std::size_t comment = line.find('#');
+    if (comment != std::string::npos) line.erase(comment);
+
+    std::istringstream in(line);
+    G4double low, high, weight;
+    if (!(in >> low)) continue;
+    if (!(in >> high >> weight) || high < low || weight < 0.) return false;
+
+    fLow.push_back(low*MeV);
+    fHigh.push_back(high*MeV);
+    fLine.push_back((low == high) ? Co60Line(low*MeV) : -1);
+    weights.push_back(weight);
+  }
+  return fTable.Build(weights);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SYPSourceSpectrum::Build()
+{
+  fLow.clear();
+  fHigh.clear();
+  fLine.clear();
+
+  G4bool ok = true;
+  if (fMode == "co60")
+  {
+    std::vector<G4double> weights;
+    for (G4int i = 0; i < kNofLines; i++)
+    {
+      fLow.push_back(kCo60Energy[i]);
+      fHigh.push_back(kCo60Energy[i]);
+      fLine.push_back(i);
+      weights.push_back(kCo60Intensity[i]);
+    }
+    ok = fTable.Build(weights);
+  }
+  else if (fMode == "file")
+  {
+    ok = ReadFile(fFileName);
+  }
+
+  if (!ok)
+  {
+    G4ExceptionDescription description;
+    description << "Cannot read the spectrum table " << fFileName;
+    G4Exception("SYPSourceSpectrum::Build()", "SYPSource001",
+                FatalException, description);
+  }
+  fValid = true;
+  return ok;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double SYPSourceSpectrum::Sample(G4int& line)
+{
+  if (!fValid) Build();
+
+  G4int bin = fTable.Sample(G4UniformRand());
+  line = fLine[bin];
+  if (fLow[bin] == fHigh[bin]) return fLow[bin];
+  return fLow[bin] + G4UniformRand()*(fHigh[bin] - fLow[bin]);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,105 @@
+/// \file SYPStackingAction.cc
+/// \brief Implementation of the SYPStackingAction class
+
+#include "SYPStackingAction.hh"
+#include "SYPEventAction.hh"
+#include "SYPDetectorConstruction.hh"
+
+#include "G4Track.hh"
+#include "G4RunManager.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4Electron.hh"
+#include "G4Gamma.hh"
+#include "G4BiasingProcessInterface.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPStackingAction::SYPStackingAction(SYPEventAction* eventAction)
+: G4UserStackingAction(),
+  fEventAction(eventAction),
+  fDetector(0),
+  fElectron(G4Electron::Definition()),
+  fGamma(G4Gamma::Definition())
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPStackingAction::~SYPStackingAction()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ClassificationOfNewTrack
+SYPStackingAction::ClassifyNewTrack(const G4Track* track)
+{
+  // the primaries have no volume yet
+  if (track->GetParentID() == 0) return fUrgent;
+
+  const G4ParticleDefinition* particle = track->GetParticleDefinition();
+  if (particle != fElectron && particle != fGamma) return fUrgent;
+
+  if (!fDetector)
+  {
+    fDetector = static_cast<const SYPDetectorConstruction*>
+      (G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  }
+
+  // a secondary is created in the volume of its parent's step
+  const G4VPhysicalVolume* volume = track->GetVolume();
+  if (!volume) return fUrgent;
+  SYPVolumeRole volumeRole = fDetector->GetVolumeRole(volume->GetLogicalVolume());
+  if (volumeRole != kMetalVolume && volumeRole != kChamberVolume)
+  {
+    return fUrgent;
+  }
+
+  SYPCreatorRole createProcess = fCreatorRoles.Get(track);
+
+  if (volumeRole == kMetalVolume)
+  {
+    if (particle == fElectron && createProcess == kCreatorEIoni)
+    {
+      fEventAction->AddKilled(kKilledStackMetalDelta);
+      return fKill;
+    }
+    return fUrgent;
+  }
+
+  // in a chamber: the first-generation e- is counted where it is created
+  if (particle == fElectron)
+  {
+    if (createProcess != kCreatorEIoni)
+    {
+      const G4TouchableHandle& touchable = track->GetTouchableHandle();
+      G4int copyNo = touchable->GetCopyNumber();
+      G4int motherCopyNo = touchable->GetCopyNumber(2);
+      // weighted when the collisions are forced in the chamber
+      fEventAction->AddCount(2*motherCopyNo+copyNo, track->GetWeight());
+    }
+    fEventAction->AddKilled(kKilledStackChamberElectron);
+    return fKill;
+  }
+  if (createProcess == kCreatorEBrem)
+  {
+    fEventAction->AddKilled(kKilledStackChamberBrem);
+    return fKill;
+  }
+
+  // a clone is made by the biasing interface that wraps no physics
+  // process; it is counted where it enters another chamber, as the
+  // primary would be
+  if (fEventAction->IsPrimaryPhoton(track->GetParentID()))
+  {
+    const G4BiasingProcessInterface* biasing
+      = dynamic_cast<const G4BiasingProcessInterface*>
+          (track->GetCreatorProcess());
+    if (biasing && !biasing->GetWrappedProcess())
+    {
+      fEventAction->AddPrimaryClone(track->GetTrackID());
+    }
+  }
+  return fUrgent;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
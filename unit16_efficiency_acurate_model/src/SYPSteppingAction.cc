@@ -4,20 +4,26 @@
 
 #include "SYPSteppingAction.hh"
 #include "SYPEventAction.hh"
-#include "SYPRunAction.hh"
 #include "SYPDetectorConstruction.hh"
+#include "SYPPhaseSpace.hh"
 
 #include "G4Step.hh"
 #include "G4Event.hh"
 #include "G4RunManager.hh"
 #include "G4LogicalVolume.hh"
+#include "G4Electron.hh"
+#include "G4Gamma.hh"
 #include "math.h"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-SYPSteppingAction::SYPSteppingAction(SYPRunAction* fRunAction)
+SYPSteppingAction::SYPSteppingAction(SYPEventAction* eventAction)
 : G4UserSteppingAction(),
-  fRunAction(fRunAction)
+  fEventAction(eventAction),
+  fDetector(0),
+  fPhaseSpace(SYPPhaseSpaceWriter::Instance()),
+  fElectron(G4Electron::Definition()),
+  fGamma(G4Gamma::Definition())
   //ScoringVolume(0)
 {}
 
@@ -28,62 +34,112 @@ SYPSteppingAction::~SYPSteppingAction()
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void SYPSteppingAction::WritePhaseSpace(const G4Step* step)
+{
+  G4double planeX = fPhaseSpace->GetPlaneX();
+  const G4StepPoint* preStepPoint = step->GetPreStepPoint();
+  const G4ThreeVector& pre = preStepPoint->GetPosition();
+  const G4ThreeVector& post = step->GetPostStepPoint()->GetPosition();
+  if (pre.x() >= planeX || post.x() < planeX) return;
+  if (!fEventAction->CrossPhaseSpacePlane()) return;
+
+  // straight step: the crossing point is interpolated, the direction
+  // and energy are those before any interaction at the post-step point
+  G4ThreeVector position = pre + (planeX - pre.x())/(post.x() - pre.x())
+                                 *(post - pre);
+  const G4ThreeVector& direction = preStepPoint->GetMomentumDirection();
+
+  SYPPhaseSpaceRecord record;
+  record.position[0] = planeX;
+  record.position[1] = position.y();
+  record.position[2] = position.z();
+  record.direction[0] = direction.x();
+  record.direction[1] = direction.y();
+  record.direction[2] = direction.z();
+  record.energy = preStepPoint->GetKineticEnergy();
+  record.weight = preStepPoint->GetWeight();
+  record.line = fEventAction->GetLine();
+  fPhaseSpace->Write(record);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void SYPSteppingAction::UserSteppingAction(const G4Step* step) {
 
-    G4TouchableHandle touchableHandle = step->GetPreStepPoint()->GetTouchableHandle();
-    G4LogicalVolume* volume = touchableHandle->GetVolume()->GetLogicalVolume();
-    G4String volumeName = volume->GetName();
+    if (!fDetector)
+    {
+        fDetector = static_cast<const SYPDetectorConstruction*>
+                (G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+    }
+
+    const G4TouchableHandle& touchableHandle = step->GetPreStepPoint()->GetTouchableHandle();
+    SYPVolumeRole volumeRole =
+            fDetector->GetVolumeRole(touchableHandle->GetVolume()->GetLogicalVolume());
     G4Track* track = step->GetTrack();
-    G4int trackID = track->GetTrackID();
+
+    // record the primary in front of the outer window
+    if (fPhaseSpace->IsWriting() && track->GetTrackID()==1)
+    {
+        WritePhaseSpace(step);
+    }
 
     // To get the detection efficiency
     // first we should count the photon
     // that enter into a particular chamber
-    if (trackID==1 && volumeName=="chamberAndWindow")
+    // (the primary, or its clone when the collisions are forced)
+    if (volumeRole==kChamberAndWindowVolume
+        && fEventAction->IsPrimaryPhoton(track->GetTrackID()))
     {
-        G4VPhysicalVolume* next_PV = step->GetPostStepPoint()->GetTouchableHandle()
-                ->GetVolume();
-        if(next_PV!=NULL)
+        const G4TouchableHandle& nextTouchable = step->GetPostStepPoint()->GetTouchableHandle();
+        G4VPhysicalVolume* next_PV = nextTouchable->GetVolume();
+        if(next_PV!=NULL &&
+           fDetector->GetVolumeRole(next_PV->GetLogicalVolume())==kChamberVolume)
         {
-            G4String nextVolumeName = next_PV->GetName();
-            if(nextVolumeName=="chamber")
-            {
-                G4int copyNo = step->GetPostStepPoint()->GetTouchableHandle()->GetCopyNumber();
-                G4int motherCopyNo = step->GetPostStepPoint()->GetTouchableHandle()->GetCopyNumber(2);
-                fRunAction->countPhoton[2*motherCopyNo+copyNo]++;
-            }
+            G4int copyNo = nextTouchable->GetCopyNumber();
+            G4int motherCopyNo = nextTouchable->GetCopyNumber(2);
+            // weighted when the air gap is crossed analytically
+            fEventAction->AddPhoton(2*motherCopyNo+copyNo, track->GetWeight());
         }
+        return;
     }
 
-    // kill the e- created by secondaries e-
-    G4String createProcess = track->GetCreatorModelName();
-    G4String particleName = track->GetParticleDefinition()->GetParticleName();
+    // nothing else is done outside the chambers and the metal
+    if (volumeRole!=kMetalVolume && volumeRole!=kChamberVolume) return;
+
+    const G4ParticleDefinition* particle = track->GetParticleDefinition();
+    if (particle!=fElectron && particle!=fGamma) return;
+    SYPCreatorRole createProcess = fCreatorRoles.Get(track);
 
-    if(particleName=="e-"&&createProcess=="eIoni"&&(volumeName=="EC"||volumeName=="ES"
-            ||volumeName=="rib"||volumeName=="shell"))
+    // kill the e- created by secondaries e-
+    if (volumeRole==kMetalVolume)
     {
-        // kill e- in metal
-        track->SetTrackStatus(fKillTrackAndSecondaries);
+        if (particle==fElectron && createProcess==kCreatorEIoni)
+        {
+            // kill e- in metal
+            track->SetTrackStatus(fKillTrackAndSecondaries);
+            fEventAction->AddKilled(kKilledStepMetalDelta);
+        }
+        return;
     }
 
     // count the secondary in chamber
-
-    if (volumeName=="chamber")
+    if (particle==fElectron)
     {
-        if(particleName=="e-" && createProcess!="eIoni")
+        if (createProcess!=kCreatorEIoni)
         {
             G4int copyNo = touchableHandle->GetCopyNumber();
             G4int motherCopyNo = touchableHandle->GetCopyNumber(2);
-            fRunAction->count[2*motherCopyNo+copyNo]++;
-        }
-        if(particleName=="e-")
-        {
-            track->SetTrackStatus(fKillTrackAndSecondaries);
-        }
-        if(particleName=="gamma"&&createProcess=="eBrem")
-        {
-            track->SetTrackStatus(fKillTrackAndSecondaries);
+            // weighted when the collisions are forced in the chamber
+            fEventAction->AddCount(2*motherCopyNo+copyNo, track->GetWeight());
         }
+        track->SetTrackStatus(fKillTrackAndSecondaries);
+        fEventAction->AddKilled(kKilledStepChamberElectron);
     }
+    else if (createProcess==kCreatorEBrem)
+    {
+        track->SetTrackStatus(fKillTrackAndSecondaries);
+        fEventAction->AddKilled(kKilledStepChamberBrem);
+    }
+}
 
-}
\ No newline at end of file
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,108 @@
+/// \file SYPTallyCheck.cc
+/// \brief Implementation of the SYPTallyCheck class
+
+#include "SYPTallyCheck.hh"
+#include "SYPRun.hh"
+
+#include "Randomize.hh"
+
+#include <cmath>
+
+namespace
+{
+  // toy units: forced collisions, and analog with up to two photons
+  // per event
+  const G4int kNofToyUnits = 2;
+
+  // weight of a photon, uniform in [0.02, 0.18] as behind an
+  // analytical attenuation
+  G4double ToyWeight()
+  {
+    return 0.02 + 0.16*G4UniformRand();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPTallyCheck::SYPTallyCheck()
+: fNofRuns(400),
+  fNofEvents(2000)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SYPTallyCheck::~SYPTallyCheck()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SYPTallyCheck::Check(G4double tolerance) const
+{
+  G4double sum[kNofToyUnits] = {};
+  G4double sum2[kNofToyUnits] = {};
+  G4double errorSum[kNofToyUnits] = {};
+
+  SYPTally run;
+  SYPTally event;
+  for (G4int k = 0; k < fNofRuns; k++)
+  {
+    run.Reset();
+    for (G4int n = 0; n < fNofEvents; n++)
+    {
+      event.Reset();
+      for (G4int i = 0; i < kNofToyUnits; i++)
+      {
+        // a photon enters unit i in 30% of the events, a second one
+        // in unit 1 in a third of those
+        G4int nofPhotons = (G4UniformRand() < 0.3) ? 1 : 0;
+        if (i == 1 && nofPhotons && G4UniformRand() < 1./3.) nofPhotons++;
+        for (G4int j = 0; j < nofPhotons; j++)
+        {
+          G4double weight = ToyWeight();
+          event.countPhoton[i] += weight;
+          if (i == 0)
+          {
+            // forced collision: the e- of the collision, weighted by
+            // its probability in [2%, 6%], escapes the gas half of
+            // the time
+            if (G4UniformRand() < 0.5)
+              event.count[i] += weight*(0.02 + 0.04*G4UniformRand());
+          }
+          else if (G4UniformRand() < 0.2)
+          {
+            // analog: the photon is detected with a probability of 20%
+            event.count[i] += weight;
+          }
+        }
+      }
+      run.AddEvent(event);
+    }
+
+    for (G4int i = 0; i < kNofToyUnits; i++)
+    {
+      G4double efficiency = run.GetEfficiency(i);
+      sum[i] += efficiency;
+      sum2[i] += efficiency*efficiency;
+      errorSum[i] += run.GetEfficiencyError(i, fNofEvents);
+    }
+  }
+
+  G4bool agree = true;
+  G4cout << " Efficiency error of " << fNofRuns << " toy runs of "
+         << fNofEvents << " weighted events:" << G4endl;
+  for (G4int i = 0; i < kNofToyUnits; i++)
+  {
+    G4double mean = sum[i]/fNofRuns;
+    G4double spread
+      = std::sqrt((sum2[i] - fNofRuns*mean*mean)/(fNofRuns - 1));
+    G4double error = errorSum[i]/fNofRuns;
+    G4double ratio = error/spread;
+    G4cout << " Unit " << i << ": efficiency " << mean
+           << ", mean error " << error << ", spread " << spread
+           << ", ratio " << ratio << G4endl;
+    if (std::fabs(ratio - 1.) > tolerance) agree = false;
+  }
+  return agree;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......